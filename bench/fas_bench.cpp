@@ -0,0 +1,1130 @@
+/**
+ * @file fas_bench.cpp
+ * @brief Microbenchmarks for the simulator's hot paths
+ * @description Runs each benchmark, prints progress to stderr and emits the
+ *              results as JSON (stdout, or the file given with --json).
+ *
+ * Usage: fas_bench [--json <file>] [--quick] [--filter <substring>]
+ */
+
+/*****************************Standard Libraries***************************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+/*************************************************************************************/
+
+/*****************************Project Headers*****************************************/
+#include "ControlCenter.h"
+#include "AssemblyStation.h"
+#include "Warehouse.h"
+#include "AGV.h"
+#include "FileHandler.h"
+#include "SimClock.h"
+#include "DiscreteEventSimulator.h"
+#include "Layout.h"
+#include "RoutePlanner.h"
+#include "FleetIndex.h"
+#include "AssignmentSolver.h"
+#include "OrderQueue.h"
+#include "BomExplosion.h"
+#include "MaterialPlanner.h"
+#include "QueueingEstimator.h"
+#include "ConfigOptimizer.h"
+/*************************************************************************************/
+
+namespace fs = std::filesystem;
+
+/****************************Benchmark Harness***************************************/
+/**
+ * @struct BenchResult
+ * @brief One measured benchmark case
+ */
+struct BenchResult {
+    std::string name;
+    std::vector<std::pair<std::string, std::string> > params;
+    long long iterations;
+    double seconds;
+    std::vector<std::pair<std::string, double> > counters;  // Extra metrics (e.g. MB/s)
+
+    BenchResult() : iterations(0), seconds(0.0) {}
+};
+
+static std::vector<BenchResult> g_results;
+static std::string g_filter;
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double elapsed_seconds(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+static bool selected(const std::string& name) {
+    return g_filter.empty() || name.find(g_filter) != std::string::npos;
+}
+
+static void report(const BenchResult& r) {
+    std::cerr << std::left << std::setw(40) << r.name;
+    for (const auto& p : r.params) std::cerr << " " << p.first << "=" << p.second;
+    double ns = r.iterations > 0 ? r.seconds * 1e9 / r.iterations : 0.0;
+    std::cerr << "  " << std::fixed << std::setprecision(1) << ns << " ns/op" << std::endl;
+    g_results.push_back(r);
+}
+
+static void write_json(std::ostream& out, bool quick) {
+    out << "{\n  \"context\": {\n";
+    out << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"assertions\": false,\n";
+#else
+    out << "    \"assertions\": true,\n";
+#endif
+    out << "    \"quick\": " << (quick ? "true" : "false") << "\n  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const BenchResult& r = g_results[i];
+        double ns = r.iterations > 0 ? r.seconds * 1e9 / r.iterations : 0.0;
+        double ops = r.seconds > 0 ? r.iterations / r.seconds : 0.0;
+        out << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"params\": {";
+        for (size_t j = 0; j < r.params.size(); ++j) {
+            out << (j ? ", " : "") << "\"" << r.params[j].first << "\": \"" << r.params[j].second << "\"";
+        }
+        out << "}, \"iterations\": " << r.iterations
+            << std::setprecision(9) << ", \"real_time_s\": " << r.seconds
+            << std::setprecision(3) << ", \"ns_per_op\": " << ns
+            << ", \"ops_per_s\": " << ops;
+        for (const auto& c : r.counters) {
+            out << ", \"" << c.first << "\": " << c.second;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/**
+ * @class NullBuffer
+ * @brief Stream buffer that discards everything (silences std::cout)
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+/*************************************************************************************/
+
+
+/****************************Warehouse Benchmarks*************************************/
+/**
+ * @brief reserve_components from several threads against one shared warehouse
+ */
+static void bench_reserve_contention(int threads, long long total_ops) {
+    Warehouse warehouse;
+    std::map<std::string, int> bom = { {"C1", 2}, {"C2", 1}, {"C3", 3} };
+    for (const auto& kv : bom) warehouse.add_component(kv.first, (int)(kv.second * total_ops + 1));
+
+    std::atomic<long long> failures(0);
+    long long per_thread = total_ops / threads;
+    auto start = BenchClock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            long long failed = 0;
+            for (long long i = 0; i < per_thread; ++i) {
+                if (!warehouse.reserve_components(bom)) failed++;
+            }
+            failures.fetch_add(failed);
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    BenchResult r;
+    r.name = "warehouse/reserve_components";
+    r.params = { {"threads", std::to_string(threads)}, {"bom_lines", std::to_string(bom.size())} };
+    r.iterations = per_thread * threads;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"failures", (double)failures.load()} };
+    report(r);
+}
+/*************************************************************************************/
+
+
+/****************************AGV Dispatch Benchmarks**********************************/
+/**
+ * @brief Round-robin is_idle() sweep over the AGVs' published status words
+ *
+ * Every AGV but the last is busy, so each decision scans half the fleet on
+ * average from the rotating start index.
+ */
+static void bench_dispatch_sweep(int fleet_size, long long decisions) {
+    std::vector<AGV*> fleet;
+    for (int i = 1; i <= fleet_size; ++i) fleet.push_back(new AGV(i));
+    for (int i = 0; i + 1 < fleet_size; ++i) fleet[i]->try_assign("C1", 1, "ASSEMBLY_STATION", nullptr);
+
+    long long found = 0;
+    size_t agv_index = 0;
+    auto start = BenchClock::now();
+    for (long long d = 0; d < decisions; ++d) {
+        for (size_t i = 0; i < fleet.size(); ++i) {
+            AGV* agv = fleet[(agv_index + i) % fleet.size()];
+            if (agv->is_idle()) { found += agv->get_id(); break; }
+        }
+        agv_index = (agv_index + 1) % fleet.size();
+    }
+    BenchResult r;
+    r.name = "dispatch/is_idle_sweep";
+    r.params = { {"fleet", std::to_string(fleet_size)} };
+    r.iterations = decisions;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"checksum", (double)found} };
+    report(r);
+    for (auto* agv : fleet) delete agv;
+}
+
+/**
+ * @brief Round-robin try_claim() sweep as done in request_components (claim, then give it back)
+ */
+static void bench_dispatch_claim(int fleet_size, long long decisions) {
+    std::vector<AGV*> fleet;
+    for (int i = 1; i <= fleet_size; ++i) fleet.push_back(new AGV(i));
+    for (int i = 0; i + 1 < fleet_size; ++i) fleet[i]->try_assign("C1", 1, "ASSEMBLY_STATION", nullptr);
+
+    long long found = 0;
+    size_t agv_index = 0;
+    auto start = BenchClock::now();
+    for (long long d = 0; d < decisions; ++d) {
+        for (size_t i = 0; i < fleet.size(); ++i) {
+            AGV* agv = fleet[(agv_index + i) % fleet.size()];
+            if (agv->try_claim()) { found += agv->get_id(); agv->release_claim(); break; }
+        }
+        agv_index = (agv_index + 1) % fleet.size();
+    }
+    BenchResult r;
+    r.name = "dispatch/try_claim_sweep";
+    r.params = { {"fleet", std::to_string(fleet_size)} };
+    r.iterations = decisions;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"checksum", (double)found} };
+    report(r);
+    for (auto* agv : fleet) delete agv;
+}
+
+/**
+ * @brief Same sweep over a flat array of atomic idle flags (no per-AGV mutex)
+ */
+static void bench_dispatch_atomic_flags(int fleet_size, long long decisions) {
+    std::vector<std::atomic<bool> > idle(fleet_size);
+    for (int i = 0; i < fleet_size; ++i) idle[i].store(i + 1 == fleet_size);
+
+    long long found = 0;
+    size_t agv_index = 0;
+    auto start = BenchClock::now();
+    for (long long d = 0; d < decisions; ++d) {
+        for (size_t i = 0; i < idle.size(); ++i) {
+            size_t k = (agv_index + i) % idle.size();
+            if (idle[k].load(std::memory_order_acquire)) { found += (long long)k + 1; break; }
+        }
+        agv_index = (agv_index + 1) % idle.size();
+    }
+    BenchResult r;
+    r.name = "dispatch/atomic_flag_sweep";
+    r.params = { {"fleet", std::to_string(fleet_size)} };
+    r.iterations = decisions;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"checksum", (double)found} };
+    report(r);
+}
+
+/**
+ * @brief Idle free list: pop an idle AGV id, then push it back when it frees up
+ */
+static void bench_dispatch_free_list(int fleet_size, long long decisions) {
+    std::mutex list_mutex;
+    std::vector<int> idle_ids;
+    idle_ids.push_back(fleet_size);  // Only the last AGV is idle
+
+    long long found = 0;
+    auto start = BenchClock::now();
+    for (long long d = 0; d < decisions; ++d) {
+        int id;
+        {
+            std::lock_guard<std::mutex> lock(list_mutex);
+            id = idle_ids.back();
+            idle_ids.pop_back();
+        }
+        found += id;
+        std::lock_guard<std::mutex> lock(list_mutex);
+        idle_ids.push_back(id);
+    }
+    BenchResult r;
+    r.name = "dispatch/idle_free_list";
+    r.params = { {"fleet", std::to_string(fleet_size)} };
+    r.iterations = decisions;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"checksum", (double)found} };
+    report(r);
+}
+/*************************************************************************************/
+
+
+/****************************Order Queue Benchmarks**********************************/
+static Order bench_order(int i) {
+    Order order;
+    order.order_id = i + 1;
+    order.release_time_minutes = 8 * 60 + i;
+    order.product_id = "PRODUCT_" + std::to_string(i % 10);
+    order.priority = i % 5;
+    return order;
+}
+
+/**
+ * @brief Push then pop on one thread: the uncontended cost per order of each queue
+ */
+static void bench_order_queue_single_thread(long long total) {
+    const int batch = 64;
+    std::vector<Order> orders;
+    for (int i = 0; i < batch; ++i) orders.push_back(bench_order(i));
+
+    {
+        std::queue<Order> queue;
+        std::mutex queue_mutex;
+        long long sum = 0;
+        auto start = BenchClock::now();
+        for (long long n = 0; n < total; n += batch) {
+            for (const auto& order : orders) { std::lock_guard<std::mutex> lock(queue_mutex); queue.push(order); }
+            for (int i = 0; i < batch; ++i) {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                sum += queue.front().order_id;
+                queue.pop();
+            }
+        }
+        BenchResult r;
+        r.name = "queue/mutex_std_queue";
+        r.params = { {"producers", "0"}, {"consumers", "0"} };
+        r.iterations = total / batch * batch;
+        r.seconds = elapsed_seconds(start);
+        r.counters = { {"checksum", (double)sum} };
+        report(r);
+    }
+    {
+        OrderQueue queue;
+        long long sum = 0;
+        OrderHandle handle;
+        auto start = BenchClock::now();
+        for (long long n = 0; n < total; n += batch) {
+            for (const auto& order : orders) queue.try_push(order);
+            while (queue.try_pop(handle)) { sum += queue.get(handle).order_id; queue.release(handle); }
+        }
+        BenchResult r;
+        r.name = "queue/lockfree_order_queue";
+        r.params = { {"producers", "0"}, {"consumers", "0"} };
+        r.iterations = total / batch * batch;
+        r.seconds = elapsed_seconds(start);
+        r.counters = { {"checksum", (double)sum} };
+        report(r);
+    }
+}
+
+/**
+ * @brief Baseline: std::queue<Order> behind a mutex and condition variable (the station's former queue)
+ */
+static void bench_order_queue_mutex(int producers, int consumers, long long total) {
+    std::queue<Order> queue;
+    std::mutex queue_mutex;
+    std::condition_variable order_cv;
+    std::atomic<long long> consumed(0);
+    std::atomic<long long> checksum(0);
+    long long per_producer = total / producers;
+    long long expected = per_producer * producers;
+
+    auto start = BenchClock::now();
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; ++p) {
+        pool.emplace_back([&, p] {
+            for (long long i = 0; i < per_producer; ++i) {
+                Order order = bench_order((int)(p * per_producer + i));
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                queue.push(order);
+                order_cv.notify_one();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        pool.emplace_back([&] {
+            long long sum = 0;
+            for (;;) {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                order_cv.wait(lock, [&] { return !queue.empty() || consumed.load() >= expected; });
+                if (queue.empty()) break;
+                Order order = queue.front();
+                queue.pop();
+                lock.unlock();
+                sum += order.order_id;
+                if (consumed.fetch_add(1) + 1 == expected) {
+                    std::lock_guard<std::mutex> relock(queue_mutex);
+                    order_cv.notify_all();
+                }
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    BenchResult r;
+    r.name = "queue/mutex_std_queue";
+    r.params = { {"producers", std::to_string(producers)}, {"consumers", std::to_string(consumers)} };
+    r.iterations = expected;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"checksum", (double)checksum.load()} };
+    report(r);
+}
+
+/**
+ * @brief OrderQueue: lock-free handle rings, orders read in place, blocking pop
+ */
+static void bench_order_queue_lockfree(int producers, int consumers, long long total) {
+    OrderQueue queue;
+    std::atomic<long long> consumed(0);
+    std::atomic<long long> checksum(0);
+    long long per_producer = total / producers;
+    long long expected = per_producer * producers;
+
+    auto start = BenchClock::now();
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; ++p) {
+        pool.emplace_back([&, p] {
+            for (long long i = 0; i < per_producer; ++i) queue.push(bench_order((int)(p * per_producer + i)));
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        pool.emplace_back([&] {
+            long long sum = 0;
+            OrderHandle handle;
+            while (queue.pop_wait(handle)) {
+                sum += queue.get(handle).order_id;
+                queue.release(handle);
+                if (consumed.fetch_add(1) + 1 == expected) queue.close();
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    OrderQueueStats stats = queue.stats();
+    BenchResult r;
+    r.name = "queue/lockfree_order_queue";
+    r.params = { {"producers", std::to_string(producers)}, {"consumers", std::to_string(consumers)} };
+    r.iterations = expected;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"checksum", (double)checksum.load()}, {"peak_depth", (double)stats.peak_depth},
+                   {"full_waits", (double)stats.full_waits} };
+    report(r);
+}
+/*************************************************************************************/
+
+
+/****************************FileHandler Benchmarks***********************************/
+static void write_synthetic_inputs(const fs::path& dir, long long lines) {
+    {
+        std::ofstream f(dir / "orders.txt");
+        for (long long i = 0; i < lines; ++i) {
+            long long minute = i % (24 * 60);
+            f << (minute / 60) << " " << (minute % 60) << " P" << (i % 1000) << " " << (i % 5) << "\n";
+        }
+    }
+    {
+        // Products with 99 component lines each (mixes all three BOM line formats)
+        std::ofstream f(dir / "bom.txt");
+        long long written = 0;
+        for (long long p = 0; written < lines; ++p) {
+            f << "P" << p << " " << (10 + p % 50) << "\n"; ++written;
+            for (int c = 0; c < 99 && written < lines; ++c, ++written) {
+                if (c % 2) f << "P" << p << " C" << ((p * 7 + c) % 10000) << " " << (1 + c % 4) << "\n";
+                else f << "C" << ((p * 7 + c) % 10000) << " " << (1 + c % 4) << "\n";
+            }
+        }
+    }
+    {
+        std::ofstream f(dir / "warehouse.txt");
+        for (long long i = 0; i < lines; ++i) f << "C" << i << " " << (100 + i % 900) << "\n";
+    }
+}
+
+static void bench_parsers(const fs::path& dir, long long lines) {
+    write_synthetic_inputs(dir, lines);
+
+    {
+        std::vector<Order> orders;
+        auto start = BenchClock::now();
+        FileHandler::read_orders_file((dir / "orders.txt").string(), orders);
+        BenchResult r;
+        r.name = "filehandler/read_orders_file";
+        r.params = { {"lines", std::to_string(lines)} };
+        r.iterations = (long long)orders.size();
+        r.seconds = elapsed_seconds(start);
+        r.counters = { {"mb_per_s", fs::file_size(dir / "orders.txt") / 1e6 / r.seconds} };
+        report(r);
+    }
+    {
+        std::map<std::string, Product> products;
+        auto start = BenchClock::now();
+        FileHandler::read_bom_file((dir / "bom.txt").string(), products);
+        BenchResult r;
+        r.name = "filehandler/read_bom_file";
+        r.params = { {"lines", std::to_string(lines)} };
+        r.iterations = lines;
+        r.seconds = elapsed_seconds(start);
+        r.counters = { {"mb_per_s", fs::file_size(dir / "bom.txt") / 1e6 / r.seconds},
+                       {"products", (double)products.size()} };
+        report(r);
+    }
+    {
+        std::map<std::string, int> inventory;
+        auto start = BenchClock::now();
+        FileHandler::read_warehouse_file((dir / "warehouse.txt").string(), inventory);
+        BenchResult r;
+        r.name = "filehandler/read_warehouse_file";
+        r.params = { {"lines", std::to_string(lines)} };
+        r.iterations = (long long)inventory.size();
+        r.seconds = elapsed_seconds(start);
+        r.counters = { {"mb_per_s", fs::file_size(dir / "warehouse.txt") / 1e6 / r.seconds} };
+        report(r);
+    }
+}
+/*************************************************************************************/
+
+
+/****************************BOM Benchmarks*****************************************/
+/**
+ * @brief Multi-level catalogue: each product above level 0 uses `fanout` products of the level below
+ */
+static std::map<std::string, Product> build_bom_tree(int levels, int per_level, int fanout) {
+    std::map<std::string, Product> products;
+    for (int l = 0; l < levels; ++l) {
+        for (int k = 0; k < per_level; ++k) {
+            std::string id = "P" + std::to_string(l) + "_" + std::to_string(k);
+            Product& p = products[id];
+            p.product_id = id;
+            p.base_assembly_time_minutes = 5;
+            for (int c = 0; c < 4; ++c) p.bom["C" + std::to_string((k * 7 + c * 13 + l) % 500)] = 1 + c;
+            for (int f = 0; l > 0 && f < fanout; ++f) {
+                p.bom["P" + std::to_string(l - 1) + "_" + std::to_string((k * fanout + f) % per_level)] = 1 + f % 2;
+            }
+        }
+    }
+    return products;
+}
+
+/**
+ * @brief Naive per-order expansion: walk the BOM tree into a component map
+ */
+static void walk_bom(const std::map<std::string, Product>& products, const Product& product, int factor,
+                     std::map<std::string, int>& required) {
+    for (const auto& item : product.bom) {
+        auto sub = products.find(item.first);
+        if (sub == products.end()) required[item.first] += item.second * factor;
+        else walk_bom(products, sub->second, item.second * factor, required);
+    }
+}
+
+/**
+ * @brief One-time explosion cost, then per-order reservation from the cache against a tree walk
+ */
+static void bench_bom_explosion(int levels, int per_level, long long reservations) {
+    std::map<std::string, Product> products = build_bom_tree(levels, per_level, 3);
+    {
+        std::string error;
+        auto start = BenchClock::now();
+        BomExplosion::explode(products, error);
+        BenchResult r;
+        r.name = "bom/explode";
+        r.params = { {"levels", std::to_string(levels)}, {"products", std::to_string(products.size())} };
+        r.iterations = (long long)products.size();
+        r.seconds = elapsed_seconds(start);
+        report(r);
+    }
+
+    std::vector<const Product*> top;
+    for (int k = 0; k < per_level; ++k) top.push_back(&products["P" + std::to_string(levels - 1) + "_" + std::to_string(k)]);
+    Warehouse warehouse;
+    for (int c = 0; c < 500; ++c) warehouse.add_component("C" + std::to_string(c), 1 << 30);
+
+    long long failures = 0;
+    auto start = BenchClock::now();
+    for (long long i = 0; i < reservations; ++i) {
+        if (!warehouse.reserve_components(top[i % top.size()]->leaf_requirements)) failures++;
+    }
+    BenchResult cached;
+    cached.name = "bom/reserve_exploded";
+    cached.params = { {"levels", std::to_string(levels)} };
+    cached.iterations = reservations;
+    cached.seconds = elapsed_seconds(start);
+    cached.counters = { {"failures", (double)failures}, {"leaves", (double)top[0]->leaf_requirements.size()} };
+    report(cached);
+
+    failures = 0;
+    start = BenchClock::now();
+    for (long long i = 0; i < reservations; ++i) {
+        std::map<std::string, int> required;
+        walk_bom(products, *top[i % top.size()], 1, required);
+        if (!warehouse.reserve_components(required)) failures++;
+    }
+    BenchResult walked;
+    walked.name = "bom/reserve_tree_walk";
+    walked.params = { {"levels", std::to_string(levels)} };
+    walked.iterations = reservations;
+    walked.seconds = elapsed_seconds(start);
+    walked.counters = { {"failures", (double)failures} };
+    report(walked);
+}
+
+/**
+ * @brief Pre-run MRP pass over a large order book (parallel demand reduction, then the projection)
+ */
+static void bench_material_plan(int threads, int num_orders) {
+    std::map<std::string, Product> products = build_bom_tree(3, 2000, 3);
+    std::string error;
+    BomExplosion::explode(products, error);
+
+    std::vector<Order> orders(num_orders);
+    for (int i = 0; i < num_orders; ++i) {
+        orders[i].order_id = i + 1;
+        orders[i].release_time_minutes = 480 + i / 100;
+        orders[i].product_id = "P" + std::to_string(i % 3) + "_" + std::to_string((i * 7919) % 2000);
+    }
+    std::map<std::string, int> inventory;
+    for (int c = 0; c < 500; ++c) inventory["C" + std::to_string(c)] = c % 10 == 0 ? num_orders / 20 : num_orders * 20;
+
+    MaterialPlanner planner(orders, products, inventory);
+    planner.set_threads(threads);
+    auto start = BenchClock::now();
+    MaterialPlan plan = planner.plan();
+    BenchResult r;
+    r.name = "mrp/plan";
+    r.params = { {"threads", std::to_string(threads)}, {"orders", std::to_string(num_orders)} };
+    r.iterations = num_orders;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"short_components", (double)plan.short_components}, {"starving_orders", (double)plan.starving_orders}, {"unbuildable_orders", (double)plan.unbuildable_orders} };
+    report(r);
+}
+/*************************************************************************************/
+
+
+/****************************Logging Benchmark****************************************/
+/**
+ * @brief log_event throughput (file sink in the scratch dir, console discarded)
+ */
+static void bench_log_event(int threads, long long messages) {
+    ControlCenter control_center;
+    long long per_thread = messages / threads;
+    auto start = BenchClock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            for (long long i = 0; i < per_thread; ++i) {
+                control_center.log_event("[Diag] assign_task C" + std::to_string(i % 100) + " to AGV" + std::to_string(t));
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    BenchResult r;
+    r.name = "controlcenter/log_event";
+    r.params = { {"threads", std::to_string(threads)} };
+    r.iterations = per_thread * threads;
+    r.seconds = elapsed_seconds(start);
+    report(r);
+}
+/*************************************************************************************/
+
+
+/****************************End-to-End Benchmark*************************************/
+/**
+ * @brief Full threaded simulation with sleeping disabled (SimClock scale 0)
+ */
+static void bench_end_to_end(const fs::path& dir, int fleet_size, int num_orders) {
+    {
+        std::ofstream f(dir / "input" / "orders.txt");
+        for (int i = 0; i < num_orders; ++i) {
+            int minute = 8 * 60 + i * 3;
+            f << (minute / 60) << " " << (minute % 60) << " P" << (1 + i % 3) << " " << (i % 5) << "\n";
+        }
+        std::ofstream b(dir / "input" / "bom.txt");
+        b << "P1 30\nP1 C1 2\nP1 C3 1\n\nP2 40\nP2 C2 2\nP2 C1 1\n\nP3 20\nP3 C2 1\nP3 C3 2\n";
+        std::ofstream w(dir / "input" / "warehouse.txt");
+        w << "C1 " << num_orders * 2 << "\nC2 " << num_orders * 2 << "\nC3 " << num_orders * 2 << "\n";
+    }
+
+    Warehouse warehouse;
+    std::vector<AGV*> fleet;
+    ControlCenter control_center;
+    AssemblyStation station(&warehouse, &fleet);
+    control_center.load_orders("input/orders.txt");
+    control_center.load_bom("input/bom.txt");
+    control_center.load_warehouse("input/warehouse.txt", &warehouse);
+    for (int i = 1; i <= fleet_size; ++i) fleet.push_back(new AGV(i));
+
+    auto start = BenchClock::now();
+    control_center.start_simulation(&station, &fleet);
+    control_center.wait_until_all_orders_complete();
+    auto stop_start = BenchClock::now();
+    control_center.stop_simulation();
+    double shutdown = elapsed_seconds(stop_start);
+    double seconds = elapsed_seconds(start);
+
+    BenchResult r;
+    r.name = "e2e/threaded_simulation";
+    r.params = { {"fleet", std::to_string(fleet_size)}, {"orders", std::to_string(num_orders)} };
+    r.iterations = num_orders;
+    r.seconds = seconds;
+    r.counters = { {"orders_per_s", num_orders / seconds}, {"shutdown_ms", shutdown * 1e3} };
+    report(r);
+    for (auto* agv : fleet) delete agv;
+}
+
+/**
+ * @brief Deterministic discrete-event run of a synthetic order book (no logging)
+ */
+static void bench_end_to_end_deterministic(int fleet_size, int num_orders) {
+    std::vector<Order> orders;
+    for (int i = 0; i < num_orders; ++i) {
+        Order order;
+        order.order_id = i + 1;
+        order.release_time_minutes = 8 * 60 + i * 3;
+        order.product_id = "P" + std::to_string(1 + i % 3);
+        order.priority = i % 5;
+        orders.push_back(order);
+    }
+    std::map<std::string, Product> products;
+    products["P1"].product_id = "P1"; products["P1"].base_assembly_time_minutes = 30;
+    products["P1"].bom = { {"C1", 2}, {"C3", 1} };
+    products["P2"].product_id = "P2"; products["P2"].base_assembly_time_minutes = 40;
+    products["P2"].bom = { {"C2", 2}, {"C1", 1} };
+    products["P3"].product_id = "P3"; products["P3"].base_assembly_time_minutes = 20;
+    products["P3"].bom = { {"C2", 1}, {"C3", 2} };
+    std::map<std::string, int> inventory = { {"C1", num_orders * 2}, {"C2", num_orders * 2}, {"C3", num_orders * 2} };
+    std::string error;
+    BomExplosion::explode(products, error);
+
+    SimulationConfig config;
+    config.num_agvs = fleet_size;
+    DiscreteEventSimulator simulator(config);
+    auto start = BenchClock::now();
+    SimulationResult result = simulator.run(orders, products, inventory);
+    double seconds = elapsed_seconds(start);
+
+    BenchResult r;
+    r.name = "e2e/deterministic_simulation";
+    r.params = { {"fleet", std::to_string(fleet_size)}, {"orders", std::to_string(num_orders)} };
+    r.iterations = num_orders;
+    r.seconds = seconds;
+    r.counters = { {"orders_per_s", num_orders / seconds},
+                   {"events_per_s", result.events_processed / seconds} };
+    report(r);
+
+    // Same order book through the analytical estimate
+    QueueingEstimator estimator(config);
+    start = BenchClock::now();
+    QueueingEstimate estimate = estimator.estimate(orders, products);
+    BenchResult e;
+    e.name = "e2e/queueing_estimate";
+    e.params = r.params;
+    e.iterations = num_orders;
+    e.seconds = elapsed_seconds(start);
+    e.counters = { {"speedup", seconds / e.seconds},
+                   {"lead_time_error_pct", 100.0 * (estimate.avg_lead_time - result.avg_lead_time) / result.avg_lead_time},
+                   {"throughput_error_pct", 100.0 * (estimate.throughput - result.throughput) / result.throughput} };
+    report(e);
+}
+
+
+/**
+ * @brief Deterministic run with multi-step routings: thousands of jobs queue at the workcenters
+ *
+ * Orders arrive faster than the workcenters clear them, so the per-workcenter
+ * queues grow to a large share of the order book.
+ */
+static void bench_routing_deterministic(int fleet_size, int num_orders) {
+    std::vector<Order> orders;
+    for (int i = 0; i < num_orders; ++i) {
+        Order order;
+        order.order_id = i + 1;
+        order.release_time_minutes = i;
+        order.product_id = "P" + std::to_string(1 + i % 3);
+        order.priority = i % 5;
+        orders.push_back(order);
+    }
+    std::vector<Workcenter> workcenters(4);
+    const char* names[] = { "mill", "drill", "test", "pack" };
+    for (int k = 0; k < 4; ++k) { workcenters[k].name = names[k]; workcenters[k].machines = 2; }
+    std::map<std::string, Product> products;
+    for (int p = 1; p <= 3; ++p) {
+        Product& product = products["P" + std::to_string(p)];
+        product.product_id = "P" + std::to_string(p);
+        product.base_assembly_time_minutes = 5;
+        product.bom = { {"C1", 1} };
+        for (int k = p % 2; k < 4; ++k) {
+            Operation op;
+            op.name = names[k];
+            op.process_minutes = 5 + 2 * k + p;
+            op.workcenters = { names[k] };
+            if (k < 2) op.workcenters.push_back(names[1 - k]);   // Mill and drill can stand in for each other
+            product.routing.push_back(op);
+        }
+    }
+    std::map<std::string, int> inventory = { {"C1", num_orders} };
+    std::string error;
+    BomExplosion::explode(products, error);
+
+    SimulationConfig config;
+    config.num_agvs = fleet_size;
+    config.station_slots = 8;
+    config.workcenters = &workcenters;
+    DiscreteEventSimulator simulator(config);
+    auto start = BenchClock::now();
+    SimulationResult result = simulator.run(orders, products, inventory);
+    double seconds = elapsed_seconds(start);
+
+    int peak_queue = 0;
+    for (const auto& wc : result.workcenter_stats) peak_queue = std::max(peak_queue, wc.peak_queue);
+    BenchResult r;
+    r.name = "e2e/deterministic_routing";
+    r.params = { {"fleet", std::to_string(fleet_size)}, {"orders", std::to_string(num_orders)} };
+    r.iterations = num_orders;
+    r.seconds = seconds;
+    r.counters = { {"orders_per_s", num_orders / seconds},
+                   {"events_per_s", result.events_processed / seconds},
+                   {"wip_moves", (double)result.wip_moves}, {"peak_queue", (double)peak_queue} };
+    report(r);
+}
+
+
+/**
+ * @brief Configuration search (fleet size x policy) with stochastic assembly times
+ */
+static void bench_config_search(int threads, int num_orders, int budget) {
+    std::vector<Order> orders;
+    for (int i = 0; i < num_orders; ++i) {
+        Order order;
+        order.order_id = i + 1;
+        order.release_time_minutes = 8 * 60 + i * 20;
+        order.product_id = "P" + std::to_string(1 + i % 3);
+        order.priority = i % 5;
+        order.due_date_minutes = order.release_time_minutes + 120 + (i % 7) * 30;
+        orders.push_back(order);
+    }
+    std::map<std::string, Product> products;
+    products["P1"].product_id = "P1"; products["P1"].base_assembly_time_minutes = 15;
+    products["P1"].bom = { {"C1", 2}, {"C3", 1} };
+    products["P2"].product_id = "P2"; products["P2"].base_assembly_time_minutes = 20;
+    products["P2"].bom = { {"C2", 2}, {"C1", 1} };
+    products["P3"].product_id = "P3"; products["P3"].base_assembly_time_minutes = 10;
+    products["P3"].bom = { {"C2", 1}, {"C3", 2} };
+    std::map<std::string, int> inventory = { {"C1", num_orders * 2}, {"C2", num_orders * 2}, {"C3", num_orders * 2} };
+    std::string error;
+    BomExplosion::explode(products, error);
+
+    SimulationConfig config;
+    config.process_times.assembly_factor = Distribution::lognormal(1.0, 0.5);
+    ConfigOptimizer optimizer(orders, products, inventory);
+    optimizer.set_threads(threads);
+    optimizer.set_max_agvs(10);
+    auto start = BenchClock::now();
+    OptimizationResult search = optimizer.optimize(config, budget);
+
+    BenchResult r;
+    r.name = "optimizer/search";
+    r.params = { {"threads", std::to_string(threads)}, {"orders", std::to_string(num_orders)},
+                 {"budget", std::to_string(budget)} };
+    r.iterations = search.simulations;
+    r.seconds = elapsed_seconds(start);
+    r.counters = { {"candidates", (double)search.candidates.size()}, {"rounds", (double)search.rounds},
+                   {"reused_runs", (double)search.reused_runs}, {"front", (double)search.front.size()} };
+    report(r);
+}
+/*************************************************************************************/
+
+/****************************Layout Benchmarks***************************************/
+/**
+ * @brief All-pairs travel-time precompute on a side x side aisle grid
+ *
+ * Rows are two-way aisles, columns alternate one-way directions.
+ */
+static std::string grid_node(int r, int c) {
+    return "N" + std::to_string(r) + "_" + std::to_string(c);
+}
+
+static void build_grid_layout(Layout& layout, int side) {
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            if (c + 1 < side) layout.add_aisle(grid_node(r, c), grid_node(r, c + 1), 10.0, 0.0, false);
+            if (r + 1 < side) {
+                if (c % 2 == 0) layout.add_aisle(grid_node(r, c), grid_node(r + 1, c), 10.0, 0.0, true);
+                else layout.add_aisle(grid_node(r + 1, c), grid_node(r, c), 10.0, 0.0, true);
+            }
+        }
+    }
+    layout.set_warehouse_node(grid_node(0, 0));
+    layout.set_station_node(grid_node(side - 1, side - 1));
+}
+
+static void bench_layout_build(int side, int threads) {
+    Layout layout;
+    build_grid_layout(layout, side);
+
+    auto start = BenchClock::now();
+    layout.build(threads);
+    double seconds = elapsed_seconds(start);
+
+    BenchResult r;
+    r.name = "layout/all_pairs_build";
+    r.params = { {"nodes", std::to_string(side * side)}, {"threads", std::to_string(threads)} };
+    r.iterations = side * side;
+    r.seconds = seconds;
+    r.counters = { {"sources_per_s", side * side / seconds} };
+    report(r);
+}
+
+/**
+ * @brief Nearest idle AGV queries on a grid: claim for a random pickup, release at a random drop-off
+ */
+static void bench_nearest_dispatch(int side, int fleet_size, int types, long long decisions) {
+    Layout layout;
+    build_grid_layout(layout, side);
+    layout.build();
+    int nodes = layout.node_count();
+
+    FleetIndex index(&layout);
+    index.reset(fleet_size);
+    uint64_t state = 99;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state >> 33;
+    };
+
+    // Vehicle types round-robin over the fleet; each task may use a random nonempty subset
+    std::vector<uint64_t> item_masks(1, FleetIndex::ANY_TYPE);
+    if (types > 1) {
+        std::vector<int> slot_types;
+        std::vector<double> speeds;
+        for (int k = 0; k < fleet_size; ++k) slot_types.push_back(k % types);
+        for (int t = 0; t < types; ++t) speeds.push_back(1.0 + 0.25 * t);
+        index.set_vehicle_types(slot_types, speeds);
+        item_masks.clear();
+        for (int i = 0; i < 64; ++i) {
+            uint64_t mask = next() & (((uint64_t)1 << types) - 1);
+            item_masks.push_back(mask ? mask : 1);
+        }
+    }
+    for (int k = 0; k < fleet_size; ++k) index.add_idle(k, (int)(next() % nodes));
+
+    double eta_sum = 0.0;
+    auto start = BenchClock::now();
+    for (long long i = 0; i < decisions; ++i) {
+        double eta = 0.0;
+        uint64_t capable = item_masks[i % item_masks.size()];
+        int slot = index.claim_nearest((int)(next() % nodes), capable, &eta);
+        eta_sum += eta;
+        index.add_idle(slot, (int)(next() % nodes));
+    }
+    double seconds = elapsed_seconds(start);
+
+    BenchResult r;
+    r.name = "layout/nearest_dispatch";
+    r.params = { {"nodes", std::to_string(nodes)}, {"fleet", std::to_string(fleet_size)},
+                 {"types", std::to_string(types)} };
+    r.iterations = decisions;
+    r.seconds = seconds;
+    r.counters = { {"decisions_per_s", decisions / seconds}, {"avg_eta_min", eta_sum / decisions} };
+    report(r);
+}
+
+/**
+ * @brief One dispatch cycle: tasks x idle AGVs Hungarian solve on grid travel times
+ */
+static void bench_assignment_cycle(int side, int tasks, int agvs, int cycles) {
+    Layout layout;
+    build_grid_layout(layout, side);
+    layout.build();
+    int nodes = layout.node_count();
+
+    uint64_t state = 7;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state >> 33;
+    };
+    std::vector<std::vector<double> > matrices(16, std::vector<double>((size_t)tasks * agvs));
+    for (auto& cost : matrices) {
+        std::vector<int> pickups(tasks), positions(agvs);
+        for (auto& p : pickups) p = (int)(next() % nodes);
+        for (auto& p : positions) p = (int)(next() % nodes);
+        for (int r = 0; r < tasks; ++r) {
+            for (int c = 0; c < agvs; ++c) cost[(size_t)r * agvs + c] = layout.travel_time(positions[c], pickups[r]);
+        }
+    }
+
+    AssignmentSolver solver;
+    double total = 0.0;
+    auto start = BenchClock::now();
+    for (int i = 0; i < cycles; ++i) {
+        const std::vector<double>& cost = matrices[i % matrices.size()];
+        const std::vector<int>& pairing = solver.solve(cost, tasks, agvs);
+        total += cost[pairing[0]];
+    }
+    double seconds = elapsed_seconds(start);
+
+    BenchResult r;
+    r.name = "layout/assignment_cycle";
+    r.params = { {"tasks", std::to_string(tasks)}, {"agvs", std::to_string(agvs)} };
+    r.iterations = cycles;
+    r.seconds = seconds;
+    r.counters = { {"solve_us", seconds * 1e6 / cycles}, {"checksum", total} };
+    report(r);
+}
+
+/**
+ * @brief Cooperative A* moves between dock nodes on a grid, at a fixed move rate
+ */
+static void bench_route_planner(int side, int moves_per_minute, int moves) {
+    Layout layout;
+    build_grid_layout(layout, side);
+    std::vector<int> docks;
+    for (int k = 0; k < 16; ++k) {
+        std::string item = "S" + std::to_string(k);
+        layout.set_storage(item, grid_node((k * 7) % side, (k * 11) % side));
+    }
+    layout.build();
+    for (int k = 0; k < 16; ++k) docks.push_back(layout.storage_node("S" + std::to_string(k)));
+    docks.push_back(layout.warehouse_node());
+    docks.push_back(layout.station_node());
+
+    RoutePlanner planner(layout);
+    uint64_t state = 12345;
+    double delay = 0.0;
+    auto start = BenchClock::now();
+    for (int i = 0; i < moves; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int from = docks[(state >> 33) % docks.size()];
+        int to = docks[(state >> 17) % docks.size()];
+        delay += planner.plan(from, to, (double)i / moves_per_minute).delay();
+    }
+    double seconds = elapsed_seconds(start);
+
+    BenchResult r;
+    r.name = "layout/congestion_routing";
+    r.params = { {"nodes", std::to_string(side * side)}, {"moves_per_min", std::to_string(moves_per_minute)} };
+    r.iterations = moves;
+    r.seconds = seconds;
+    r.counters = { {"moves_per_s", moves / seconds},
+                   {"avg_delay_min", delay / moves},
+                   {"expansions_per_move", (double)planner.get_expansions() / moves} };
+    report(r);
+}
+/*************************************************************************************/
+
+
+/*******************************Main Function*****************************************/
+int main(int argc, char* argv[]) {
+    std::string json_file;
+    bool quick = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) json_file = argv[++i];
+        else if (arg == "--quick") quick = true;
+        else if (arg == "--filter" && i + 1 < argc) g_filter = argv[++i];
+        else {
+            std::cerr << "Usage: fas_bench [--json <file>] [--quick] [--filter <substring>]\n";
+            return 1;
+        }
+    }
+    if (!json_file.empty()) json_file = fs::absolute(json_file).string();
+
+    // All relative paths used by the simulator (input/, output/) resolve in a scratch dir
+    fs::path original_dir = fs::current_path();
+    fs::path scratch = fs::temp_directory_path() /
+        ("fas_bench_" + std::to_string(BenchClock::now().time_since_epoch().count()));
+    fs::create_directories(scratch / "input");
+    fs::create_directories(scratch / "output");
+    fs::current_path(scratch);
+
+    NullBuffer null_buffer;
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    SimClock::set_time_scale(0.0);
+
+    long long scale = quick ? 10 : 1;
+
+    if (selected("warehouse")) {
+        for (int threads : {1, 2, 4, 8}) bench_reserve_contention(threads, 400000 / scale);
+    }
+    if (selected("dispatch")) {
+        for (int fleet : {10, 100, 1000}) {
+            bench_dispatch_sweep(fleet, 2000000 / scale / fleet * 10);
+            bench_dispatch_claim(fleet, 2000000 / scale / fleet * 10);
+            bench_dispatch_atomic_flags(fleet, 2000000 / scale / fleet * 10);
+            bench_dispatch_free_list(fleet, 2000000 / scale);
+        }
+    }
+    if (selected("queue")) {
+        bench_order_queue_single_thread(4000000 / scale);
+        for (int threads : {1, 2, 4}) {
+            bench_order_queue_mutex(threads, threads, 2000000 / scale);
+            bench_order_queue_lockfree(threads, threads, 2000000 / scale);
+        }
+    }
+    if (selected("filehandler")) {
+        bench_parsers(scratch, 1000000 / scale);
+    }
+    if (selected("bom")) {
+        for (int levels : {1, 3, 5}) bench_bom_explosion(levels, quick ? 200 : 2000, 20000 / scale);
+    }
+    if (selected("mrp")) {
+        for (int threads : {1, 2, 4}) bench_material_plan(threads, 1000000 / (int)scale);
+    }
+    if (selected("optimizer")) {
+        for (int threads : {1, 2, 4}) bench_config_search(threads, 1000 / (int)scale, 200);
+    }
+    if (selected("log_event")) {
+        for (int threads : {1, 4}) bench_log_event(threads, 200000 / scale);
+    }
+    if (selected("layout")) {
+        for (int threads : {1, 4}) bench_layout_build(quick ? 20 : 50, threads);
+        for (int rate : {10, 100, 500}) bench_route_planner(30, rate, 20000 / (int)scale);
+        for (int fleet : {10, 100, 1000}) bench_nearest_dispatch(30, fleet, 1, 200000 / scale);
+        for (int types : {4, 16}) bench_nearest_dispatch(30, 1000, types, 200000 / scale);
+        bench_assignment_cycle(30, 10, 100, 2000 / (int)scale);
+        bench_assignment_cycle(30, 20, 300, 1000 / (int)scale);
+        bench_assignment_cycle(30, 100, 300, 100 / (int)scale);
+    }
+    if (selected("e2e")) {
+        for (int fleet : {2, 5, 10, 20}) bench_end_to_end(scratch, fleet, quick ? 30 : 200);
+        for (int fleet : {2, 20, 200}) bench_end_to_end_deterministic(fleet, 1000000 / (int)scale);
+        bench_routing_deterministic(50, 200000 / (int)scale);
+    }
+
+    std::cout.rdbuf(cout_buffer);
+    fs::current_path(original_dir);
+    fs::remove_all(scratch);
+
+    if (json_file.empty()) {
+        write_json(std::cout, quick);
+    } else {
+        std::ofstream out(json_file);
+        if (!out.is_open()) {
+            std::cerr << "Error: Cannot create file " << json_file << std::endl;
+            return 1;
+        }
+        write_json(out, quick);
+    }
+    return 0;
+}
+/********************************End of Main Function********************************/
@@ -6,11 +6,36 @@
 /******************************Project Headers*****************************************/
 #include "AGV.h"
 #include "AssemblyStation.h"
+#include "SimClock.h"
+#include "Layout.h"
+#include "FleetIndex.h"
+#include "TaskLatch.h"
 #include <iostream>
 #include <chrono>
+#include <cmath>
 #include <thread>
 /*************************************************************************************/
 
+namespace {
+// Status word layout: state (bits 0-7), claimed (bit 8), finished product (bit 9), task sequence (bits 32-63)
+const uint64_t STATE_MASK = 0xFF;
+const uint64_t CLAIMED = (uint64_t)1 << 8;
+const uint64_t FINISHED = (uint64_t)1 << 9;
+const int SEQ_SHIFT = 32;
+
+uint64_t pack_status(AGVState state, bool claimed, bool finished, uint32_t seq) {
+    return (uint64_t)state | (claimed ? CLAIMED : 0) | (finished ? FINISHED : 0) | ((uint64_t)seq << SEQ_SHIFT);
+}
+
+AGVState status_state(uint64_t word) {
+    return (AGVState)(word & STATE_MASK);
+}
+
+uint32_t status_seq(uint64_t word) {
+    return (uint32_t)(word >> SEQ_SHIFT);
+}
+}
+
 /****************************AGV Methods**********************************************/
 /**
  * @brief Constructor for AGV
@@ -18,14 +43,24 @@
  */
 AGV::AGV(int id) 
     : agv_id(id), 
-      state(AGVState::IDLE), 
+      status(pack_status(AGVState::IDLE, false, false, 0)),
       running(false),
+      shut_down(false),
       travel_time_warehouse_minutes(2),
       travel_time_station_minutes(3),
       picking_time_minutes(1),
       dropping_time_minutes(1),
+      layout(nullptr),
+      location(-1),
+      fleet_index(nullptr),
+      fleet_slot(-1),
+      task_latch(nullptr),
+      type_index(0),
+      speed_factor(1.0),
       total_operations(0),
-      busy_time_minutes(0) {
+      busy_time_minutes(0),
+      empty_distance_m(0),
+      loaded_distance_m(0) {
 }
 
 /**
@@ -33,9 +68,7 @@ AGV::AGV(int id)
  */
 AGV::~AGV() {
     stop();
-    if (agv_thread.joinable()) {
-        agv_thread.join();
-    }
+    join();
 }
 
 
@@ -51,11 +84,88 @@ void AGV::start() {
  * @brief Stop the AGV thread
  */
 void AGV::stop() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        shut_down = true;
+    }
     running = false;
     task_cv.notify_all(); //Signal to stop
 }
 
 
+/**
+ * @brief Wait for the AGV thread to exit (call after stop())
+ */
+void AGV::join() {
+    if (agv_thread.joinable()) {
+        agv_thread.join();
+    }
+}
+
+
+/**
+ * @brief Drive on a shop-floor layout, starting at its home node
+ * @param floor Built layout, or nullptr for the fixed nominal travel times
+ *
+ * Call before start().
+ */
+void AGV::set_layout(const Layout* floor) {
+    layout = (floor && floor->is_built()) ? floor : nullptr;
+    location = layout ? layout->home_node() : -1;
+}
+
+
+/**
+ * @brief Publish this AGV's idle position to a dispatcher index
+ * @param index Shared index (nullptr disables)
+ * @param slot Position of this AGV in the fleet vector
+ *
+ * Call after set_layout() and before start(); the AGV registers now and
+ * again each time it finishes a task.
+ */
+void AGV::set_fleet_index(FleetIndex* index, int slot) {
+    fleet_index = index;
+    fleet_slot = slot;
+    if (fleet_index) fleet_index->add_idle(fleet_slot, location);
+}
+
+
+/**
+ * @brief Drive as a fleet profile vehicle type
+ * @param type_name Type name for reports
+ * @param type Type index in the profile (checked against capability masks for backhauls)
+ * @param speed Speed relative to nominal (travel legs take nominal time / speed)
+ *
+ * Call before start().
+ */
+void AGV::set_vehicle_type(const std::string& type_name, int type, double speed) {
+    vehicle_type = type_name;
+    type_index = type;
+    speed_factor = speed > 0.0 ? speed : 1.0;
+}
+
+
+/**
+ * @brief Travel time of the current task's next leg
+ * @param to_pickup true for current position -> pickup, false for pickup -> drop-off
+ * @return Minutes (matrix lookup with a layout, nominal constant otherwise), over the speed factor
+ *
+ * Components are picked at their storage node and dropped at the station;
+ * finished products go from the station to their storage node.
+ */
+double AGV::leg_minutes(bool to_pickup) const {
+    if (!layout) {
+        return (to_pickup ? travel_time_warehouse_minutes : travel_time_station_minutes) / speed_factor;
+    }
+    int storage = layout->storage_node(current_task.component_id);
+    int station = layout->station_node();
+    int pickup = current_task.is_finished_product ? station : storage;
+    int dropoff = current_task.is_finished_product ? storage : station;
+    return (to_pickup ? layout->travel_time(location.load(std::memory_order_relaxed), pickup)
+                      : layout->travel_time(pickup, dropoff)) / speed_factor;
+}
+
+
 /**
  * @brief Main AGV state machine loop
  */
@@ -75,63 +185,163 @@ void AGV::run() {
         }
         
         // Travel to pickup
+        double to_pickup_minutes = leg_minutes(true);
+        double to_dropoff_minutes = leg_minutes(false);
         transition_to(AGVState::TO_WAREHOUSE);
         lock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(
-            travel_time_warehouse_minutes * 100)); // Scaled for simulation
+        SimClock::sleep_ms((int)(to_pickup_minutes * 100)); // Scaled for simulation
         
         // Picking
         lock.lock(); transition_to(AGVState::PICKING); lock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(
-            picking_time_minutes * 100));
+        SimClock::sleep_ms(picking_time_minutes * 100);
         
         // Travel to destination
         lock.lock(); transition_to(AGVState::TO_STATION); lock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(
-            travel_time_station_minutes * 100));
+        SimClock::sleep_ms((int)(to_dropoff_minutes * 100));
         
         // Dropping
         lock.lock(); transition_to(AGVState::DROPPING); lock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(
-            dropping_time_minutes * 100));
+        SimClock::sleep_ms(dropping_time_minutes * 100);
         
         // Complete task
         lock.lock();
         current_task.is_complete = true;
-        busy_time_minutes.fetch_add(travel_time_warehouse_minutes + 
-                                    picking_time_minutes + 
-                                    travel_time_station_minutes + 
-                                    dropping_time_minutes, std::memory_order_relaxed);
+        busy_time_minutes.fetch_add((int)std::lround(to_pickup_minutes +
+                                                     picking_time_minutes +
+                                                     to_dropoff_minutes +
+                                                     dropping_time_minutes), std::memory_order_relaxed);
+        if (layout) {
+            int storage = layout->storage_node(current_task.component_id);
+            int pickup = current_task.is_finished_product ? layout->station_node() : storage;
+            int dropoff = current_task.is_finished_product ? storage : layout->station_node();
+            empty_distance_m.fetch_add(std::llround(layout->distance(location, pickup)), std::memory_order_relaxed);
+            loaded_distance_m.fetch_add(std::llround(layout->distance(pickup, dropoff)), std::memory_order_relaxed);
+            location = dropoff;
+        }
         total_operations.fetch_add(1, std::memory_order_relaxed);
         
-        if (current_task.notify_station && current_task.destination == std::string("ASSEMBLY_STATION")) {
+        std::string backhaul_product;
+        int backhaul_quantity = 0;
+        AssemblyStation* station_to_notify = current_task.notify_station;
+        if (station_to_notify && current_task.destination == std::string("ASSEMBLY_STATION")) {
             // Call without holding the mutex to avoid potential deadlocks
-            AssemblyStation* station_to_notify = current_task.notify_station;
             std::string comp = current_task.component_id;
             bool finished = current_task.is_finished_product;
+            int slot = current_task.station_slot;
+            int quantity = current_task.quantity;
             lock.unlock();
             if (!finished) {
-                station_to_notify->notify_component_delivered(comp, 1);
-            } else {
-                // Finished product delivered back to warehouse; nothing to notify station
+                // Claim a waiting finished product before the station sees its last delivery
+                station_to_notify->take_backhaul(backhaul_product, backhaul_quantity, type_index);
+                station_to_notify->notify_component_delivered(comp, quantity, slot);
             }
             lock.lock();
+        } else if (station_to_notify && current_task.is_finished_product) {
+            // Finished lot delivered back to storage
+            std::string product = current_task.component_id;
+            int quantity = current_task.quantity;
+            lock.unlock();
+            station_to_notify->notify_finished_product_delivered(product, quantity);
+            lock.lock();
+        }
+
+        if (!backhaul_product.empty()) {
+            current_task = AGVTask();
+            current_task.component_id = backhaul_product;
+            current_task.quantity = backhaul_quantity;
+            current_task.destination = "WAREHOUSE";
+            current_task.notify_station = station_to_notify;
+            current_task.is_finished_product = true;
+            carry_backhaul(lock);
         }
         
-        // Reset task
+        // Reset task and publish the AGV as claimable again
         current_task = AGVTask();
-        transition_to(AGVState::IDLE);
+        status.store(pack_status(AGVState::IDLE, false, false, status_seq(status.load(std::memory_order_relaxed))),
+                     std::memory_order_release);
+        if (fleet_index) fleet_index->add_idle(fleet_slot, location);
+        if (task_latch) task_latch->end();
         lock.unlock();
     }
 }
 
 
+/**
+ * @brief Take a finished product from the station to its storage node
+ * @param lock Held state_mutex; released while driving and held again on return
+ *
+ * The AGV has just dropped components at the station, so the return starts
+ * with the pick and has no empty leg.
+ */
+void AGV::carry_backhaul(std::unique_lock<std::mutex>& lock) {
+    double return_minutes = leg_minutes(false);
+    transition_to(AGVState::PICKING); lock.unlock();
+    SimClock::sleep_ms(picking_time_minutes * 100);
+
+    lock.lock(); transition_to(AGVState::RETURNING); lock.unlock();
+    SimClock::sleep_ms((int)(return_minutes * 100));
+
+    lock.lock(); transition_to(AGVState::DROPPING); lock.unlock();
+    SimClock::sleep_ms(dropping_time_minutes * 100);
+
+    lock.lock();
+    current_task.is_complete = true;
+    busy_time_minutes.fetch_add((int)std::lround(picking_time_minutes + return_minutes + dropping_time_minutes),
+                                std::memory_order_relaxed);
+    if (layout) {
+        int storage = layout->storage_node(current_task.component_id);
+        loaded_distance_m.fetch_add(std::llround(layout->distance(layout->station_node(), storage)),
+                                    std::memory_order_relaxed);
+        location = storage;
+    }
+    total_operations.fetch_add(1, std::memory_order_relaxed);
+
+    std::string product = current_task.component_id;
+    int quantity = current_task.quantity;
+    AssemblyStation* station = current_task.notify_station;
+    lock.unlock();
+    station->notify_finished_product_delivered(product, quantity);
+    lock.lock();
+}
+
+
 /**
  * @brief Transition AGV to a new state
  * @param new_state The new state to transition to
+ *
+ * Only the AGV thread calls this, while the AGV is claimed, so no
+ * dispatcher can change the status word concurrently.
  */
 void AGV::transition_to(AGVState new_state) {
-    state = new_state;
+    uint64_t word = status.load(std::memory_order_relaxed);
+    status.store((word & ~STATE_MASK) | (uint64_t)new_state, std::memory_order_release);
+}
+
+
+/**
+ * @brief Claim an idle AGV for one task
+ * @return true if this caller won the AGV; it must follow with assign_task() or release_claim()
+ *
+ * A single compare-and-swap on the status word, so two dispatchers can
+ * never both take the same AGV.
+ */
+bool AGV::try_claim() {
+    uint64_t word = status.load(std::memory_order_acquire);
+    if (status_state(word) != AGVState::IDLE || (word & CLAIMED)) return false;
+    uint64_t claimed = pack_status(AGVState::IDLE, true, false, status_seq(word) + 1);
+    return status.compare_exchange_strong(word, claimed, std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+
+/**
+ * @brief Give back a claim that was not followed by assign_task()
+ */
+void AGV::release_claim() {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    uint64_t word = status.load(std::memory_order_relaxed);
+    if (!(word & CLAIMED) || status_state(word) != AGVState::IDLE || !current_task.component_id.empty()) return;
+    status.store(pack_status(AGVState::IDLE, false, false, status_seq(word)), std::memory_order_release);
+    if (fleet_index && !shut_down) fleet_index->add_idle(fleet_slot, location);
 }
 
 
@@ -139,50 +349,94 @@ void AGV::transition_to(AGVState new_state) {
 /**
  * @brief Assign a new task to the AGV
  * @param component_id ID of the component to pick
- * @param quantity Quantity to pick (per task, should be 1)
+ * @param quantity Units to carry (more than 1 for a lot)
  * @param destination Destination ("ASSEMBLY_STATION" or "WAREHOUSE")
  * @param notify_station Optional station to notify upon delivery
+ * @param is_finished_product true for a finished-product return
+ * @param station_slot Station slot the component is for
+ * @return ASSIGNED only if the AGV took the task; on any other result the task was not queued
+ *
+ * The caller must hold the claim from try_claim(). A rejected caller still
+ * holds its claim and gives it back with release_claim().
  */
-void AGV::assign_task(const std::string& component_id, int quantity,
-                      const std::string& destination,
-                      AssemblyStation* notify_station,
-                      bool is_finished_product) {
+AssignResult AGV::assign_task(const std::string& component_id, int quantity,
+                              const std::string& destination,
+                              AssemblyStation* notify_station,
+                              bool is_finished_product,
+                              int station_slot) {
     std::lock_guard<std::mutex> lock(state_mutex);  //mustex wait assign task
     
-    if (state == AGVState::IDLE && current_task.component_id.empty()) {
-        current_task.component_id = component_id;
-        current_task.quantity = quantity;
-        current_task.destination = destination;
-        current_task.is_complete = false;
-        current_task.notify_station = notify_station;
-        current_task.is_finished_product = is_finished_product;
-        task_cv.notify_one();   // Signal new task
+    if (shut_down) return AssignResult::STOPPED;
+    uint64_t word = status.load(std::memory_order_relaxed);
+    if (!(word & CLAIMED) || status_state(word) != AGVState::IDLE || !current_task.component_id.empty()) {
+        return AssignResult::NOT_IDLE;
     }
+    status.store(pack_status(AGVState::IDLE, true, is_finished_product, status_seq(word)), std::memory_order_release);
+    current_task.component_id = component_id;
+    current_task.quantity = quantity;
+    current_task.destination = destination;
+    current_task.is_complete = false;
+    current_task.notify_station = notify_station;
+    current_task.is_finished_product = is_finished_product;
+    current_task.station_slot = station_slot;
+    if (task_latch) task_latch->begin();
+    task_cv.notify_one();   // Signal new task
+    return AssignResult::ASSIGNED;
 }
 
 
 /**
- * @brief Check if AGV is idle
+ * @brief Claim the AGV and hand it a task in one call
+ * @return ASSIGNED if the AGV took the task; otherwise it is left unclaimed and the task must go elsewhere
+ */
+AssignResult AGV::try_assign(const std::string& component_id, int quantity,
+                             const std::string& destination,
+                             AssemblyStation* notify_station,
+                             bool is_finished_product,
+                             int station_slot) {
+    if (!try_claim()) return AssignResult::NOT_IDLE;
+    AssignResult result = assign_task(component_id, quantity, destination, notify_station, is_finished_product,
+                                      station_slot);
+    if (result != AssignResult::ASSIGNED) release_claim();
+    return result;
+}
+
+
+/**
+ * @brief Check if AGV is idle and unclaimed (wait-free)
  * @return true if AGV is idle, false otherwise
  */
 bool AGV::is_idle() const {
-    std::lock_guard<std::mutex> lock(state_mutex);  //mustex wait check idle
-    return state == AGVState::IDLE && current_task.component_id.empty();
+    uint64_t word = status.load(std::memory_order_acquire);
+    return status_state(word) == AGVState::IDLE && !(word & CLAIMED);
 }
 
 
 /**
- * @brief Get the current state of the AGV
+ * @brief Get the current state of the AGV (wait-free)
  * @return Current AGV state
  */
 AGVState AGV::get_state() const {
-    std::lock_guard<std::mutex> lock(state_mutex);  //mustex wait get state
-    return state;
+    return status_state(status.load(std::memory_order_acquire));
+}
+
+
+/**
+ * @brief State and task descriptor from one atomic load (wait-free)
+ */
+AGVSnapshot AGV::snapshot() const {
+    uint64_t word = status.load(std::memory_order_acquire);
+    AGVSnapshot snap;
+    snap.state = status_state(word);
+    snap.claimed = (word & CLAIMED) != 0;
+    snap.finished_product = (word & FINISHED) != 0;
+    snap.task_seq = status_seq(word);
+    return snap;
 }
 
 
 /**
- * @brief Get the current task assigned to the AGV
+ * @brief Get a full copy of the current task (takes state_mutex; use snapshot() in dispatch loops)
  * @return Current AGV task
  */
 AGVTask AGV::get_current_task() const {
@@ -8,6 +8,7 @@
 
 /******************************Project Headers*****************************************/
 #include <string>
+#include <cstdint>
 #include <mutex>
 #include <thread>
 #include <atomic>
@@ -16,6 +17,9 @@
 
 // Forward declaration to avoid circular include
 class AssemblyStation;
+class Layout;
+class FleetIndex;
+class TaskLatch;
 
 /****************************AGV Class Definition*************************************/
 /**
@@ -28,7 +32,18 @@ enum class AGVState {
     PICKING,
     TO_STATION,
     DROPPING,
-    RETURNING
+    CHARGING,                           // Driving to, waiting for or plugged into a charger
+    RETURNING                           // Carrying a finished product back from the station (backhaul)
+};
+
+/**
+ * @enum AssignResult
+ * @brief Outcome of handing a task to an AGV
+ */
+enum class AssignResult {
+    ASSIGNED,                           // Accepted: the AGV will carry out the task
+    NOT_IDLE,                           // Working or claimed by another dispatcher; try another AGV
+    STOPPED                             // The AGV has been stopped and takes no more work
 };
 
 /**
@@ -42,22 +57,60 @@ struct AGVTask {
     bool is_complete;
     AssemblyStation* notify_station;   // Optional callback target
     bool is_finished_product;          // true when transporting finished product back to warehouse
+    int station_slot;                  // Station slot waiting for the component
     
-    AGVTask() : quantity(0), is_complete(false), notify_station(nullptr), is_finished_product(false) {}
+    AGVTask() : quantity(0), is_complete(false), notify_station(nullptr), is_finished_product(false), station_slot(0) {}
+};
+
+/**
+ * @struct AGVSnapshot
+ * @brief Wait-free view of an AGV: its state and a compact descriptor of its task
+ */
+struct AGVSnapshot {
+    AGVState state;
+    bool claimed;                       // A dispatcher owns the AGV (task assigned or being assigned)
+    bool finished_product;              // Current task returns a finished product
+    uint32_t task_seq;                  // Claims so far; changes with every new task
+
+    AGVSnapshot() : state(AGVState::IDLE), claimed(false), finished_product(false), task_seq(0) {}
+};
+
+/**
+ * @struct AgvStatistics
+ * @brief Per-vehicle totals for the AGV report
+ */
+struct AgvStatistics {
+    int agv_id;
+    int operations;
+    double busy_minutes;
+    double congestion_delay_minutes;    // Waiting for other AGVs (congestion routing)
+    double empty_km;                    // Deadhead travel to pickups (layout only)
+    double loaded_km;
+    double charging_minutes;            // Out of service for charging (battery model only)
+    std::string vehicle_type;           // Fleet profile type ("" without a fleet file)
+
+    AgvStatistics() : agv_id(0), operations(0), busy_minutes(0.0), congestion_delay_minutes(0.0),
+                      empty_km(0.0), loaded_km(0.0), charging_minutes(0.0) {}
 };
 
 /**
  * @class AGV
  * @brief Represents an Automated Guided Vehicle (AGV) with state machine
+ *
+ * The state, a claimed flag and a task descriptor are published in one
+ * atomic status word, so is_idle(), get_state() and snapshot() never wait
+ * for the AGV thread. Dispatchers take an idle AGV with try_claim() (a
+ * compare-and-swap that only one caller can win) before assign_task().
  */
 class AGV {
 private:
     int agv_id;
-    AGVState state;
-    AGVTask current_task;
+    std::atomic<uint64_t> status;       // Packed AGVSnapshot (see AGV.cpp)
+    AGVTask current_task;               // Guarded by state_mutex
     mutable std::mutex state_mutex;
     std::condition_variable task_cv;
     std::atomic<bool> running;
+    bool shut_down;                     // stop() was called; guarded by state_mutex
     std::thread agv_thread;
     
     // Timing parameters (in simulated minutes)
@@ -65,8 +118,22 @@ private:
     int travel_time_station_minutes;
     int picking_time_minutes;
     int dropping_time_minutes;
+
+    // Shop-floor position (travel legs come from the layout matrix when set)
+    const Layout* layout;
+    std::atomic<int> location;          // Layout node index, -1 without layout
+    FleetIndex* fleet_index;            // Re-registers here when idle (nearest-vehicle dispatch)
+    int fleet_slot;
+    TaskLatch* task_latch;              // Counts accepted tasks for the shutdown drain
+
+    // Vehicle type (fleet profile)
+    std::string vehicle_type;
+    int type_index;                     // Fleet profile type (bit in capability masks)
+    double speed_factor;                // Travel legs take nominal time / speed_factor
     
     void run();
+    double leg_minutes(bool to_pickup) const;
+    void carry_backhaul(std::unique_lock<std::mutex>& lock);
     void transition_to(AGVState new_state);
     
 public:
@@ -75,18 +142,36 @@ public:
     
     void start();
     void stop();
-    void assign_task(const std::string& component_id, int quantity, 
-                     const std::string& destination,
-                     AssemblyStation* notify_station,
-                     bool is_finished_product = false);
+    void join();
+    bool try_claim();
+    void release_claim();
+    AssignResult assign_task(const std::string& component_id, int quantity,
+                             const std::string& destination,
+                             AssemblyStation* notify_station,
+                             bool is_finished_product = false,
+                             int station_slot = 0);
+    AssignResult try_assign(const std::string& component_id, int quantity,
+                            const std::string& destination,
+                            AssemblyStation* notify_station,
+                            bool is_finished_product = false,
+                            int station_slot = 0);
     bool is_idle() const;
     AGVState get_state() const;
+    AGVSnapshot snapshot() const;
     int get_id() const { return agv_id; }
+    void set_layout(const Layout* floor);
+    void set_fleet_index(FleetIndex* index, int slot);
+    void set_task_latch(TaskLatch* latch) { task_latch = latch; }
+    void set_vehicle_type(const std::string& type_name, int type, double speed);
+    const std::string& get_vehicle_type() const { return vehicle_type; }
+    int get_location() const { return location.load(std::memory_order_relaxed); }
     AGVTask get_current_task() const;
     
     // Statistics
     std::atomic<int> total_operations;
     std::atomic<int> busy_time_minutes;
+    std::atomic<long long> empty_distance_m;    // Deadhead travel to pickups (layout only)
+    std::atomic<long long> loaded_distance_m;
 };
 /*************************************************************************************/
 #endif /* AGV_H */
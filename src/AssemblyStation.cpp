@@ -7,6 +7,10 @@
 #include "AssemblyStation.h"
 #include "ControlCenter.h"
 #include "AGV.h"
+#include "SimClock.h"
+#include "FleetIndex.h"
+#include "FleetProfile.h"
+#include "SetupMatrix.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -29,11 +33,21 @@ AssemblyStation::AssemblyStation(Warehouse* wh, std::vector<AGV*>* fleet)
       agv_fleet(fleet),
       control_center(nullptr),
       products(nullptr),
+      layout(nullptr),
+      fleet_index(nullptr),
+      fleet_profile(nullptr),
+      setup_matrix(nullptr),
       running(false),
       current_sim_time_minutes(0),
       setup_time_minutes(5),
+      capacity(1),
+      pending_deliveries(1),
+      backhaul_enabled(false),
       total_busy_time_minutes(0),
-      orders_completed(0) {
+      total_setup_minutes(0),
+      orders_completed(0),
+      slot_clock(1, 0),
+      last_product(1) {
 }
 
 
@@ -42,102 +56,193 @@ AssemblyStation::AssemblyStation(Warehouse* wh, std::vector<AGV*>* fleet)
  */
 AssemblyStation::~AssemblyStation() {
     stop();
-    if (station_thread.joinable()) {
-        station_thread.join();
-    }
 }
 
 
 /**
- * @brief Start the assembly station processing thread
+ * @brief Set the number of slots (orders assembled in parallel); call before start()
+ * @param slots Capacity, at least 1
+ */
+void AssemblyStation::set_capacity(int slots) {
+    capacity = std::max(slots, 1);
+    pending_deliveries.assign(capacity, std::map<std::string, int>());
+    slot_clock.assign(capacity, 0);
+    last_product.assign(capacity, std::string());
+}
+
+
+/**
+ * @brief Start one worker thread per slot
  */
 void AssemblyStation::start() {
     running = true;
-    station_thread = std::thread(&AssemblyStation::process_orders, this);  //Wait for orders
+    order_queue.open();
+    for (int slot = 0; slot < capacity; ++slot) {
+        workers.emplace_back(&AssemblyStation::process_orders, this, slot);  //Wait for orders
+    }
 }
 
 
 /**
- * @brief Stop the assembly station processing thread
+ * @brief Stop the assembly station worker threads
  */
 void AssemblyStation::stop() {
     running = false;
-    // Wake any waits so the thread can exit promptly
-    order_cv.notify_all();
-    delivery_cv.notify_all();
-    // Join the station thread to avoid late logs after stopping
-    if (station_thread.joinable()) {
-        station_thread.join();
+    // Wake any waits so the threads can exit promptly
+    order_queue.close();
+    {
+        std::lock_guard<std::mutex> lk(delivery_mutex);
+        delivery_cv.notify_all();
     }
+    // Join the workers to avoid late logs after stopping
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+    // No component trips are coming anymore; send waiting finished products home
+    std::deque<std::pair<std::string, int> > waiting;
+    {
+        std::lock_guard<std::mutex> lk(delivery_mutex);
+        waiting.swap(outbound);
+    }
+    for (const auto& lot : waiting) dispatch_finished_product(lot.first, lot.second);
 }
 
 
 /**
- * @brief Main processing loop for assembly station
+ * @brief Processing loop of one station slot
+ * @param slot Slot served by this worker
  */
-void AssemblyStation::process_orders() {
+void AssemblyStation::process_orders(int slot) {
     while (running) {
-        std::unique_lock<std::mutex> lock(queue_mutex);  
-        order_cv.wait(lock, [this] { return !running || !order_queue.empty(); });
-        if (!running && order_queue.empty()) break;
-        if (order_queue.empty()) continue;
-        Order order = order_queue.front();
-        order_queue.pop();
-        lock.unlock();
+        OrderHandle handle;
+        if (!order_queue.pop_wait(handle)) break;   // Closed and empty
+        const Order& order = order_queue.get(handle);
         
-        if (!request_components(order.product_id)) {
-            int attempts = ++retry_counts[order.order_id];
+        if (!request_components(order.product_id, order.lot_size, slot)) {
+            release_outbound();   // No deliveries are coming for waiting finished products
+            if (!running) {       // Stopping, not a failed attempt
+                order_queue.release(handle);
+                break;
+            }
+            int attempts = 0;
+            {
+                std::lock_guard<std::mutex> lk(retry_mutex);
+                attempts = ++retry_counts[order.order_id];
+            }
             if (attempts > max_request_retries) {
                 if (control_center) control_center->log_event("[Diag] request_components failed permanently for order ID " + std::to_string(order.order_id));
                 if (control_center) control_center->mark_order_canceled(order.order_id);
+                order_queue.release(handle);
                 continue;
             }
             if (control_center) control_center->log_event("[Diag] request_components failed (attempt " + std::to_string(attempts) + ") requeue order " + order.product_id);
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            std::lock_guard<std::mutex> relock(queue_mutex);
-            order_queue.push(order);
-            order_cv.notify_one();
+            SimClock::sleep_ms(100);
+            order_queue.requeue(handle);
             continue;
         }
 
-        retry_counts.erase(order.order_id);
+        {
+            std::lock_guard<std::mutex> lk(retry_mutex);
+            retry_counts.erase(order.order_id);
+        }
 
-        int operation_time = calculate_operation_time(order.product_id);
-        int order_start_time = std::max(current_sim_time_minutes.load(), order.release_time_minutes);
+        // A single slot follows the station clock; parallel slots each keep their own
+        int setup = setup_time(order.product_id, slot);
+        int operation_time = calculate_operation_time(order.product_id, order.lot_size, setup);
+        int slot_ready = capacity == 1 ? current_sim_time_minutes.load() : slot_clock[slot];
+        int order_start_time = std::max(slot_ready, order.release_time_minutes);
         total_busy_time_minutes += operation_time;
-        std::this_thread::sleep_for(std::chrono::milliseconds(operation_time * 10));
+        total_setup_minutes += setup;
+        last_product[slot] = order.product_id;
+        SimClock::sleep_ms(operation_time * 10);
         int completion_time = order_start_time + operation_time;
-        current_sim_time_minutes = completion_time;
-        orders_completed++;
+        slot_clock[slot] = completion_time;
+        int clock = current_sim_time_minutes.load();
+        while (clock < completion_time && !current_sim_time_minutes.compare_exchange_weak(clock, completion_time)) {}
+        orders_completed += order.lot_size;
+        if (control_center) { control_center->record_station_busy(order_start_time, completion_time); }
         if (control_center) { control_center->mark_order_completed(order.order_id, completion_time); }
         
-        // Dispatch finished product return by an AGV (non-blocking)
-        bool dispatched = false;
-        for (int retry = 0; retry < 50 && !dispatched; ++retry) {
-            for (size_t i = 0; i < agv_fleet->size(); ++i) {
-                AGV* agv = (*agv_fleet)[i];
-                if (agv->is_idle()) {
-                    if (control_center) control_center->log_event("[Diag] assign finished product " + order.product_id + " to AGV" + std::to_string(agv->get_id()));
-                    agv->assign_task(order.product_id, 1, "WAREHOUSE", this, true);
-                    dispatched = true;
-                    break;
-                }
+        // Return the finished product: on the next component delivery's trip back
+        // when deliveries are pending or another order follows, otherwise by a
+        // dedicated AGV. Decided under delivery_mutex so release_outbound cannot
+        // run between the check and the push.
+        bool wait_for_backhaul = false;
+        if (backhaul_enabled) {
+            std::lock_guard<std::mutex> lk(delivery_mutex);
+            wait_for_backhaul = deliveries_pending() || !order_queue.empty();
+            if (wait_for_backhaul) {
+                outbound.push_back(std::make_pair(order.product_id, order.lot_size));
+                if (control_center) control_center->log_event("[Diag] finished product " + order.product_id + " waits for backhaul");
             }
-            if (!dispatched) std::this_thread::sleep_for(std::chrono::milliseconds(50));
         }
-        if (!dispatched && control_center) {
-            control_center->log_event("[Diag] could not dispatch finished product return for " + order.product_id + " immediately");
+        if (!wait_for_backhaul) dispatch_finished_product(order.product_id, order.lot_size);
+        order_queue.release(handle);
+        if (order_queue.empty()) release_outbound();   // Last order done: nothing else will come back empty
+    }
+}
+
+
+/**
+ * @brief Hand a finished product to an idle AGV for the trip to storage (non-blocking)
+ * @param product_id ID of the finished product
+ * @param quantity Units of the lot, carried together
+ */
+void AssemblyStation::dispatch_finished_product(const std::string& product_id, int quantity) {
+    size_t agv_index = 0;
+    AGV* agv = nullptr;
+    for (int retry = 0; retry < 50 && !agv; ++retry) {
+        agv = dispatch_task(product_id, quantity, layout ? layout->station_node() : -1, "WAREHOUSE", true, 0, agv_index);
+        if (!agv) SimClock::sleep_ms(50);
+    }
+    if (!agv && control_center) {
+        control_center->log_event("[Diag] could not dispatch finished product return for " + product_id + " immediately");
+    }
+}
+
+
+/**
+ * @brief Dispatch finished products that no component AGV will take as a backhaul
+ *
+ * Products keep waiting while any slot still expects a component delivery.
+ */
+void AssemblyStation::release_outbound() {
+    std::deque<std::pair<std::string, int> > waiting;
+    {
+        std::lock_guard<std::mutex> lk(delivery_mutex);
+        if (deliveries_pending()) return;
+        waiting.swap(outbound);
+    }
+    for (const auto& lot : waiting) dispatch_finished_product(lot.first, lot.second);
+}
+
+
+/**
+ * @brief Check whether any slot still expects a component delivery (caller holds delivery_mutex)
+ */
+bool AssemblyStation::deliveries_pending() const {
+    for (const auto& slot : pending_deliveries) {
+        for (const auto& kv : slot) {
+            if (kv.second > 0) return true;
         }
     }
+    return false;
 }
 
 
 /**
  * @brief Request components for a product from the warehouse
  * @param product_id ID of the product to assemble
+ * @param lot_size Orders assembled together (components are reserved for all of them)
+ * @param slot Station slot the components are delivered to
  * @return true if components were successfully requested, false otherwise
+ *
+ * A lot is reserved in one call and moved in as many trips as one order
+ * needs, each trip carrying the units of every order in the lot. A trip
+ * heavier than the largest capable vehicle's payload is split.
  */
-bool AssemblyStation::request_components(const std::string& product_id) {
+bool AssemblyStation::request_components(const std::string& product_id, int lot_size, int slot) {
     if (!products) {
         return false;
     }
@@ -149,76 +254,140 @@ bool AssemblyStation::request_components(const std::string& product_id) {
     
     const Product& product = it->second;  // Get product details
     
-    // Reserve components (this also checks availability)
-    if (!warehouse->reserve_components(product.bom)) {
+    // Reserve the exploded BOM (this also checks availability)
+    if (!warehouse->reserve_components(product.leaf_requirements, lot_size)) {
         return false;
     }
     
     // Assign AGVs to transport components
     if (!agv_fleet || agv_fleet->empty()) {
-        warehouse->reserve_components(product.bom); // Rollback - simplified
+        for (const auto& req : product.leaf_requirements) {   // Rollback
+            warehouse->add_component(req.component_id, req.quantity * lot_size);
+        }
         return false;
     }
 
     // Initialize pending deliveries
     {
         std::lock_guard<std::mutex> lk(delivery_mutex);
-        pending_deliveries.clear();
-        for (const auto& kv : product.bom) {
-            // One unit per task; we need kv.second tasks
-            pending_deliveries[kv.first] = kv.second;
+        pending_deliveries[slot].clear();
+        for (const auto& req : product.leaf_requirements) {
+            // One task per BOM unit, each carrying lot_size units
+            pending_deliveries[slot][req.component_id] = req.quantity * lot_size;
         }
     }
     
-    // Assign AGV tasks for each component unit
-    int agv_index = 0;
-    for (const auto& component : product.bom) {
-        const std::string& comp_id = component.first;
-        int qty = component.second;
-        for (int q = 0; q < qty; ++q) {
-            bool assigned = false;
-            // Try to find an idle AGV; if none, wait briefly and retry
-            for (int retry = 0; retry < 50 && !assigned; ++retry) {
-                for (size_t i = 0; i < agv_fleet->size(); i++) {
-                    AGV* agv = (*agv_fleet)[(agv_index + i) % agv_fleet->size()];  // Round-robin
-                    if (agv->is_idle()) {
-                        if (control_center) control_center->log_event("[Diag] assign_task " + comp_id + " to AGV" + std::to_string(agv->get_id()));
-                        agv->assign_task(comp_id, 1, "ASSEMBLY_STATION", this);
-                        assigned = true;
-                        agv_index = (agv_index + i + 1) % agv_fleet->size();
-                        break;
+    // Assign AGV tasks for each component unit; a unit only counts once an AGV accepted it
+    size_t agv_index = 0;
+    const std::vector<ComponentRequirement>& reqs = product.leaf_requirements;
+    for (size_t c = 0; c < reqs.size(); ++c) {
+        const std::string& comp_id = reqs[c].component_id;
+        int target = layout ? layout->storage_node(comp_id) : -1;
+        int per_trip = fleet_profile ? std::min(lot_size, fleet_profile->max_units(comp_id)) : lot_size;
+        int undispatched = reqs[c].quantity * lot_size;
+        for (int q = 0; q < reqs[c].quantity; ++q) {
+            for (int left = lot_size; left > 0; left -= per_trip) {
+                // Wait for an AGV to accept the trip; give up only if the station is stopping
+                while (!dispatch_task(comp_id, std::min(per_trip, left), target, "ASSEMBLY_STATION", false, slot, agv_index)) {
+                    if (!running) {
+                        // Rollback what no AGV carries; trips under way are not waited for
+                        warehouse->add_component(comp_id, undispatched);
+                        for (size_t rest = c + 1; rest < reqs.size(); ++rest) {
+                            warehouse->add_component(reqs[rest].component_id, reqs[rest].quantity * lot_size);
+                        }
+                        {
+                            std::lock_guard<std::mutex> lk(delivery_mutex);
+                            pending_deliveries[slot].clear();
+                        }
+                        if (control_center) control_center->log_event("[Diag] station stopped before all components of " + product_id + " were dispatched");
+                        return false;
                     }
+                    SimClock::sleep_ms(50);
                 }
-                if (!assigned) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                }
-            }
-            if (!assigned) {
-                // Could not assign now; push back simple delay and try again later
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                --q; // retry this unit
+                undispatched -= std::min(per_trip, left);
             }
         }
     }
     
     // Wait for all components to be delivered
     if (control_center) control_center->log_event("[Diag] wait_for_components start");
-    wait_for_components(product_id);
+    wait_for_components(product_id, slot);
     if (control_center) control_center->log_event("[Diag] wait_for_components done");
+    release_outbound();
     
     return true;
 }
 
 
+/**
+ * @brief Take the idle AGV that may carry an item and reaches its pickup first
+ * @param target Pickup node (-1 without a layout)
+ * @param item_id Component or product, checked against the fleet profile
+ * @param quantity Units on the trip (their total weight must fit the payload)
+ * @return The claimed AGV, or nullptr without a fleet index or if none is idle
+ *
+ * A claimed AGV leaves the index until it re-registers after its task, so
+ * it cannot be handed out twice; the caller still takes the AGV's own
+ * claim (try_assign) before it counts as dispatched.
+ */
+AGV* AssemblyStation::claim_nearest_agv(int target, const std::string& item_id, int quantity) {
+    if (!fleet_index || !agv_fleet) return nullptr;
+    uint64_t capable = fleet_profile ? fleet_profile->capability_mask(item_id, quantity) : FleetIndex::ANY_TYPE;
+    int slot = fleet_index->claim_nearest(target, capable);
+    return slot >= 0 ? (*agv_fleet)[slot] : nullptr;
+}
+
+
+/**
+ * @brief Hand one transport to an AGV, rerouting it if the chosen AGV rejects it
+ * @param item_id Component or finished product to carry
+ * @param quantity Units carried on the trip
+ * @param target Pickup node (-1 without a layout)
+ * @param destination "ASSEMBLY_STATION" or "WAREHOUSE"
+ * @param is_finished_product true for a finished-product return
+ * @param slot Station slot a component is for
+ * @param agv_index Round-robin start position, advanced past the chosen AGV
+ * @return The AGV that accepted the task, or nullptr if every AGV is busy or stopped
+ *
+ * With a fleet index, the nearest capable AGV is tried first and the next
+ * nearest on rejection; otherwise the fleet is swept round-robin.
+ */
+AGV* AssemblyStation::dispatch_task(const std::string& item_id, int quantity, int target, const std::string& destination,
+                                    bool is_finished_product, int slot, size_t& agv_index) {
+    const std::string what = is_finished_product ? "finished product " : "";
+    const std::string assigned = is_finished_product ? "[Diag] assign finished product " : "[Diag] assign_task ";
+    while (AGV* agv = claim_nearest_agv(target, item_id, quantity)) {
+        AssignResult result = agv->try_assign(item_id, quantity, destination, this, is_finished_product, slot);
+        if (result == AssignResult::ASSIGNED) {
+            if (control_center) control_center->log_event(assigned + item_id + " to AGV" + std::to_string(agv->get_id()));
+            return agv;
+        }
+        if (control_center) control_center->log_event("[Diag] AGV" + std::to_string(agv->get_id()) + " rejected " + what + item_id + ", rerouting");
+    }
+    if (fleet_index || !agv_fleet) return nullptr;
+
+    for (size_t i = 0; i < agv_fleet->size(); ++i) {
+        AGV* agv = (*agv_fleet)[(agv_index + i) % agv_fleet->size()];  // Round-robin
+        if (agv->try_assign(item_id, quantity, destination, this, is_finished_product, slot) == AssignResult::ASSIGNED) {
+            if (control_center) control_center->log_event(assigned + item_id + " to AGV" + std::to_string(agv->get_id()));
+            agv_index = (agv_index + i + 1) % agv_fleet->size();
+            return agv;
+        }
+    }
+    return nullptr;
+}
+
+
 /**
  * @brief Wait for components to be delivered by AGVs
  * @param product_id ID of the product to assemble
+ * @param slot Slot whose deliveries are awaited
  */
-void AssemblyStation::wait_for_components(const std::string& /*product_id*/) {
+void AssemblyStation::wait_for_components(const std::string& /*product_id*/, int slot) {
     std::unique_lock<std::mutex> lk(delivery_mutex);
-    delivery_cv.wait(lk, [this] {
+    delivery_cv.wait(lk, [this, slot] {
         if (!running.load()) return true; // allow exit on stop()
-        for (const auto& kv : pending_deliveries) {
+        for (const auto& kv : pending_deliveries[slot]) {
             if (kv.second > 0) return false; // still waiting
         }
         return true; // all delivered
@@ -228,18 +397,21 @@ void AssemblyStation::wait_for_components(const std::string& /*product_id*/) {
 
 /**
  * @brief Called by AGV when a component unit is delivered
+ * @param slot Station slot the unit was dispatched for
  */
-void AssemblyStation::notify_component_delivered(const std::string& component_id, int quantity) {
+void AssemblyStation::notify_component_delivered(const std::string& component_id, int quantity, int slot) {
     if (control_center) control_center->log_event("[Diag] delivered " + component_id + " x" + std::to_string(quantity));
     std::lock_guard<std::mutex> lk(delivery_mutex);
-    auto it = pending_deliveries.find(component_id);
-    if (it != pending_deliveries.end()) {
+    if (slot < 0 || slot >= (int)pending_deliveries.size()) return;
+    std::map<std::string, int>& pending = pending_deliveries[slot];
+    auto it = pending.find(component_id);
+    if (it != pending.end()) {
         it->second -= quantity;
         if (it->second <= 0) it->second = 0;
     }
-    // If all delivered, notify waiter
+    // If all delivered, notify the slot's waiter (workers share the condition variable)
     bool all_done = true;
-    for (const auto& kv : pending_deliveries) {
+    for (const auto& kv : pending) {
         if (kv.second > 0) { all_done = false; break; }
     }
     if (all_done) {
@@ -250,30 +422,71 @@ void AssemblyStation::notify_component_delivered(const std::string& component_id
 
 /**
  * @brief Called by AGV when a finished product is delivered back to warehouse
+ * @param quantity Units delivered (the lot size)
  */
-void AssemblyStation::notify_finished_product_delivered(const std::string& product_id) {
+void AssemblyStation::notify_finished_product_delivered(const std::string& product_id, int quantity) {
     if (control_center) control_center->log_event("[Diag] finished product delivered " + product_id);
-    warehouse->add_finished_product(product_id);
+    warehouse->add_finished_product(product_id, quantity);
+}
+
+
+/**
+ * @brief Give a waiting finished product to an AGV that just dropped components here
+ * @param product_id Set to the product to carry back
+ * @param quantity Set to its units (the lot size)
+ * @param vehicle_type Fleet profile type of the AGV
+ * @return false if backhaul is off or nothing waiting may ride on this type
+ *
+ * Products the type may not carry stay queued for a capable AGV
+ * (release_outbound).
+ */
+bool AssemblyStation::take_backhaul(std::string& product_id, int& quantity, int vehicle_type) {
+    std::lock_guard<std::mutex> lk(delivery_mutex);
+    if (!backhaul_enabled) return false;
+    auto it = outbound.begin();
+    if (fleet_profile) {
+        while (it != outbound.end() && !((fleet_profile->capability_mask(it->first, it->second) >> vehicle_type) & 1)) ++it;
+    }
+    if (it == outbound.end()) return false;
+    product_id = it->first;
+    quantity = it->second;
+    outbound.erase(it);
+    if (control_center) control_center->log_event("[Diag] backhaul finished product " + product_id);
+    return true;
 }
 
 
 /**
  * @brief Calculate the operation time for assembling a product
  * @param product_id ID of the product
+ * @param lot_size Units assembled after one setup
+ * @param setup Changeover minutes before it (T_setup)
  * @return Operation time in minutes
  */
-int AssemblyStation::calculate_operation_time(const std::string& product_id) {
+int AssemblyStation::calculate_operation_time(const std::string& product_id, int lot_size, int setup) {
     if (!products) {
-        return 30 + setup_time_minutes; // Default fallback
+        return 30 * lot_size + setup; // Default fallback
     }
     
     auto it = products->find(product_id);
     if (it == products->end()) {
-        return 30 + setup_time_minutes; // Default fallback
+        return 30 * lot_size + setup; // Default fallback
     }
     
-    // T_op = T_base + T_setup
-    return it->second.base_assembly_time_minutes + setup_time_minutes;
+    // T_op = lot_size * T_base (subassemblies included) + T_setup
+    return it->second.total_assembly_minutes * lot_size + setup;
+}
+
+
+/**
+ * @brief Changeover time before a product on a slot
+ * @param product_id Next product
+ * @param slot Slot whose previous product counts
+ * @return Setup minutes (the flat T_setup without a setup matrix)
+ */
+int AssemblyStation::setup_time(const std::string& product_id, int slot) const {
+    if (!setup_matrix) return setup_time_minutes;
+    return setup_matrix->setup_minutes(last_product[slot], product_id);
 }
 
 
@@ -282,10 +495,10 @@ int AssemblyStation::calculate_operation_time(const std::string& product_id) {
  * @param order The order to add
  */
 void AssemblyStation::add_order(const Order& order) {
-    std::lock_guard<std::mutex> lock(queue_mutex);  //wait a new order 
-    order_queue.push(order);
-    order_cv.notify_one();  //signal a new order
-};
+    if (!order_queue.push(order) && control_center) {   // Waits while the queue is full
+        control_center->log_event("[Diag] station stopped, order ID " + std::to_string(order.order_id) + " not queued");
+    }
+}
 
 
 
@@ -303,9 +516,17 @@ void AssemblyStation::set_simulation_time(int minutes) {
  * @return true if processing, false otherwise
  */
 bool AssemblyStation::is_processing() const {
-    std::lock_guard<std::mutex> lock(queue_mutex);
     return !order_queue.empty();
 }
+
+
+/**
+ * @brief Get the number of orders waiting in the station queue
+ * @return Queue length
+ */
+int AssemblyStation::get_queue_length() const {
+    return order_queue.depth();
+}
 /*************************************************************************************/
 //# Response
 
@@ -9,6 +9,7 @@
 #include "Order.h"
 #include "Product.h"
 #include "Warehouse.h"
+#include "OrderQueue.h"
 #include <map>
 /*************************************************************************************/
 
@@ -16,18 +17,27 @@
 /****************************Forward Declarations*************************************/
 class AGV;
 class ControlCenter;
+class Layout;
+class FleetIndex;
+class FleetProfile;
+class SetupMatrix;
 #include <vector>
-#include <queue>
 #include <mutex>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 /*************************************************************************************/
 
 /****************************AssemblyStation Class Definition*************************/
 /**
  * @class AssemblyStation
  * @brief Represents an assembly station that processes orders
+ *
+ * A station has one or more slots (fixtures or operators). Each slot has
+ * its own worker thread that takes the next order from the shared queue,
+ * requests its components, waits for the deliveries addressed to that slot
+ * and assembles it.
  */
 class AssemblyStation {
 private:
@@ -35,33 +45,49 @@ private:
     std::vector<AGV*>* agv_fleet;
     ControlCenter* control_center;  // For reporting order completion
     std::map<std::string, Product>* products;  // Reference to product BOM
-    std::queue<Order> order_queue;
-    mutable std::mutex queue_mutex;
-    std::condition_variable order_cv;
-    std::thread station_thread;
+    const Layout* layout;           // Pickup nodes for nearest-vehicle dispatch
+    FleetIndex* fleet_index;        // Idle AGVs by position (nullptr: round-robin)
+    const FleetProfile* fleet_profile;  // Vehicle capabilities (nullptr: any AGV carries anything)
+    const SetupMatrix* setup_matrix;    // Sequence-dependent setups (nullptr: flat T_setup)
+    OrderQueue order_queue;         // Lock-free; orders travel as slot handles
+    std::vector<std::thread> workers;   // One per slot
     std::atomic<bool> running;
     std::atomic<int> current_sim_time_minutes;
     
     // Configuration
     int setup_time_minutes;  // T_setup
+    int capacity;            // Slots
     
-    void process_orders();
-    bool request_components(const std::string& product_id);
-    void wait_for_components(const std::string& product_id);
-    int calculate_operation_time(const std::string& product_id);
+    void process_orders(int slot);
+    bool request_components(const std::string& product_id, int lot_size, int slot);
+    void wait_for_components(const std::string& product_id, int slot);
+    int calculate_operation_time(const std::string& product_id, int lot_size, int setup);
+    int setup_time(const std::string& product_id, int slot) const;
+    AGV* claim_nearest_agv(int target, const std::string& item_id, int quantity);
+    AGV* dispatch_task(const std::string& item_id, int quantity, int target, const std::string& destination,
+                       bool is_finished_product, int slot, size_t& agv_index);
+    void dispatch_finished_product(const std::string& product_id, int quantity);
+    void release_outbound();
+    bool deliveries_pending() const;
     
     // Delivery coordination
     std::mutex delivery_mutex;
     std::condition_variable delivery_cv;
-    std::map<std::string, int> pending_deliveries; // component_id -> units remaining
+    std::vector<std::map<std::string, int> > pending_deliveries; // Per slot: component_id -> units remaining
+    bool backhaul_enabled;                         // Hold finished products for component AGVs
+    std::deque<std::pair<std::string, int> > outbound;   // Finished lots (product, units) waiting for a backhaul
 
     // Retry control to avoid infinite loops
-    std::map<int, int> retry_counts; // order_id -> attempts
+    std::mutex retry_mutex;
+    std::map<int, int> retry_counts; // order_id -> attempts (guarded by retry_mutex)
     const int max_request_retries = 100; // configurable
     
     // Statistics
-    int total_busy_time_minutes;
-    int orders_completed;
+    std::atomic<int> total_busy_time_minutes;   // Slot-minutes spent assembling
+    std::atomic<int> total_setup_minutes;       // Part of it spent on changeovers
+    std::atomic<int> orders_completed;
+    std::vector<int> slot_clock;                // Per slot: end of its last assembly (own worker only)
+    std::vector<std::string> last_product;      // Per slot: product assembled last (own worker only)
     
 public:
     AssemblyStation(Warehouse* wh, std::vector<AGV*>* fleet);
@@ -73,15 +99,26 @@ public:
     void set_simulation_time(int minutes);
     void set_products(std::map<std::string, Product>* prods) { products = prods; }
     void set_control_center(ControlCenter* cc) { control_center = cc; }
+    void set_fleet_index(FleetIndex* index, const Layout* floor, const FleetProfile* profile) {
+        fleet_index = index; layout = floor; fleet_profile = profile;
+    }
+    void set_backhaul(bool enabled) { backhaul_enabled = enabled; }
+    void set_setup_matrix(const SetupMatrix* setups) { setup_matrix = setups; }
+    void set_capacity(int slots);
+    int get_capacity() const { return capacity; }
 
     // Called by AGVs when units are delivered
-    void notify_component_delivered(const std::string& component_id, int quantity);
-    void notify_finished_product_delivered(const std::string& product_id);
+    void notify_component_delivered(const std::string& component_id, int quantity, int slot = 0);
+    void notify_finished_product_delivered(const std::string& product_id, int quantity);
+    bool take_backhaul(std::string& product_id, int& quantity, int vehicle_type);
     
     // Statistics
     int get_total_busy_time() const { return total_busy_time_minutes; }
+    int get_total_setup_time() const { return total_setup_minutes; }
     int get_orders_completed() const { return orders_completed; }
     bool is_processing() const;
+    int get_queue_length() const;
+    OrderQueueStats get_queue_stats() const { return order_queue.stats(); }
 };
 /*************************************************************************************/
 #endif /* ASSEMBLY_STATION_H */
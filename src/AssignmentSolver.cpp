@@ -0,0 +1,68 @@
+/**
+ * @file AssignmentSolver.cpp
+ * @brief Hungarian algorithm implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "AssignmentSolver.h"
+#include <limits>
+#include <cstddef>
+/*************************************************************************************/
+
+/****************************AssignmentSolver Methods********************************/
+/**
+ * @brief Solve the assignment problem
+ * @param cost Row-major rows x cols matrix (rows <= cols); use a large finite value for forbidden pairs
+ * @param rows Number of rows (tasks)
+ * @param cols Number of columns (AGVs)
+ * @return Column assigned to each row
+ *
+ * Rows are added one at a time; each addition grows a shortest augmenting
+ * path over the reduced costs and then flips the matching along it.
+ */
+const std::vector<int>& AssignmentSolver::solve(const std::vector<double>& cost, int rows, int cols) {
+    const double INF = std::numeric_limits<double>::infinity();
+    result.assign(rows > 0 ? rows : 0, -1);
+    if (rows <= 0 || cols < rows) return result;
+
+    u.assign(rows + 1, 0.0);
+    v.assign(cols + 1, 0.0);
+    match.assign(cols + 1, 0);
+    way.assign(cols + 1, 0);
+
+    for (int i = 1; i <= rows; ++i) {
+        match[0] = i;
+        int j0 = 0;
+        min_slack.assign(cols + 1, INF);
+        used.assign(cols + 1, 0);
+        do {
+            used[j0] = 1;
+            int i0 = match[j0];
+            const double* row = &cost[(std::size_t)(i0 - 1) * cols];
+            double delta = INF;
+            int j1 = 0;
+            for (int j = 1; j <= cols; ++j) {
+                if (used[j]) continue;
+                double slack = row[j - 1] - u[i0] - v[j];
+                if (slack < min_slack[j]) { min_slack[j] = slack; way[j] = j0; }
+                if (min_slack[j] < delta) { delta = min_slack[j]; j1 = j; }
+            }
+            for (int j = 0; j <= cols; ++j) {
+                if (used[j]) { u[match[j]] += delta; v[j] -= delta; }
+                else min_slack[j] -= delta;
+            }
+            j0 = j1;
+        } while (match[j0] != 0);
+        do {
+            int j1 = way[j0];
+            match[j0] = match[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (int j = 1; j <= cols; ++j) {
+        if (match[j] != 0) result[match[j] - 1] = j - 1;
+    }
+    return result;
+}
+/*************************************************************************************/
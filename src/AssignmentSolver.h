@@ -0,0 +1,38 @@
+/**
+ * @file AssignmentSolver.h
+ * @brief Minimum-cost assignment of transport tasks to AGVs (Hungarian algorithm)
+ */
+
+#ifndef ASSIGNMENT_SOLVER_H
+#define ASSIGNMENT_SOLVER_H
+
+/*****************************Standard Libraries***************************************/
+#include <vector>
+/*************************************************************************************/
+
+/****************************AssignmentSolver Class Definition************************/
+/**
+ * @class AssignmentSolver
+ * @brief Rectangular assignment: every row gets a distinct column at minimum total cost
+ *
+ * Shortest-augmenting-path Hungarian algorithm with dual potentials,
+ * O(rows^2 * cols) for rows <= cols. Work buffers are kept between calls so
+ * a dispatcher solving one matrix per cycle does not allocate.
+ */
+class AssignmentSolver {
+public:
+    AssignmentSolver() {}
+
+    const std::vector<int>& solve(const std::vector<double>& cost, int rows, int cols);
+
+private:
+    std::vector<double> u;               // Row potentials (1-based)
+    std::vector<double> v;               // Column potentials (1-based)
+    std::vector<int> match;              // Column -> row (1-based, 0 = free)
+    std::vector<int> way;
+    std::vector<double> min_slack;
+    std::vector<char> used;
+    std::vector<int> result;
+};
+/*************************************************************************************/
+#endif /* ASSIGNMENT_SOLVER_H */
@@ -0,0 +1,40 @@
+/**
+ * @file Battery.h
+ * @brief AGV battery and charging parameters
+ */
+
+#ifndef BATTERY_H
+#define BATTERY_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+/*************************************************************************************/
+
+/*****************************BatteryModel Structure Definition************************/
+/**
+ * @struct BatteryModel
+ * @brief State-of-charge drain, charger pool and charging policy (percent of full charge)
+ *
+ * Threshold policy: an AGV that finishes a task below `threshold` drives to
+ * the chargers, queues for a free one and charges to `target`. Opportunity
+ * policy additionally plugs in AGVs that go idle below `target` while a
+ * charger is free; they are unplugged for new work once above `threshold`.
+ */
+struct BatteryModel {
+    bool enabled;                // false: AGVs never run out of charge
+    bool opportunity;            // Opportunity charging during idle windows
+    double initial;              // State of charge at the start of the run
+    double drain_empty;          // Per minute driving empty
+    double drain_loaded;         // Per minute driving loaded
+    double drain_handling;       // Per minute picking or dropping
+    double charge_rate;          // Per minute on a charger
+    double threshold;            // Charge after a task when below this
+    double target;               // Leave the charger at this level
+    int chargers;                // Charging points
+    std::string charger_node;    // Layout node of the chargers (empty: home node)
+
+    BatteryModel() : enabled(false), opportunity(false), initial(100.0), drain_empty(0.2), drain_loaded(0.3),
+                     drain_handling(0.1), charge_rate(1.0), threshold(20.0), target(90.0), chargers(1) {}
+};
+/*************************************************************************************/
+#endif /* BATTERY_H */
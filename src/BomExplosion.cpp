@@ -0,0 +1,72 @@
+/**
+ * @file BomExplosion.cpp
+ * @brief Multi-level BOM explosion implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "BomExplosion.h"
+/*************************************************************************************/
+
+/****************************BomExplosion Methods************************************/
+/**
+ * @brief Compute leaf requirements and total assembly time for every product
+ * @param products Catalogue; each product's explosion cache is overwritten
+ * @param error Set to a description of the first cycle found
+ * @return false if a BOM contains a cycle
+ */
+bool BomExplosion::explode(std::map<std::string, Product>& products, std::string& error) {
+    std::map<std::string, VisitState> state;
+    std::vector<std::string> path;
+    for (const auto& entry : products) {
+        if (!expand(entry.first, products, state, path, error)) return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Expand one product after its subassemblies (depth first)
+ * @param path Products on the current walk, for the cycle message
+ */
+bool BomExplosion::expand(const std::string& product_id, std::map<std::string, Product>& products,
+                          std::map<std::string, VisitState>& state, std::vector<std::string>& path,
+                          std::string& error) {
+    VisitState& visit = state[product_id];
+    if (visit == DONE) return true;
+    if (visit == IN_PROGRESS) {
+        error = "cycle";
+        bool on_cycle = false;
+        for (const auto& id : path) {
+            on_cycle = on_cycle || id == product_id;
+            if (on_cycle) error += " " + id + " ->";
+        }
+        error += " " + product_id;
+        return false;
+    }
+    visit = IN_PROGRESS;
+    path.push_back(product_id);
+
+    Product& product = products[product_id];
+    std::map<std::string, long long> leaves;
+    long long minutes = product.base_assembly_time_minutes;
+    for (const auto& item : product.bom) {
+        auto sub = products.find(item.first);
+        if (sub == products.end()) {
+            leaves[item.first] += item.second;
+            continue;
+        }
+        if (!expand(item.first, products, state, path, error)) return false;
+        for (const auto& req : sub->second.leaf_requirements) leaves[req.component_id] += (long long)req.quantity * item.second;
+        minutes += (long long)sub->second.total_assembly_minutes * item.second;
+    }
+
+    product.leaf_requirements.clear();
+    product.leaf_requirements.reserve(leaves.size());
+    for (const auto& leaf : leaves) product.leaf_requirements.push_back(ComponentRequirement(leaf.first, (int)leaf.second));
+    product.total_assembly_minutes = (int)minutes;
+
+    path.pop_back();
+    state[product_id] = DONE;
+    return true;
+}
+/*************************************************************************************/
@@ -0,0 +1,43 @@
+/**
+ * @file BomExplosion.h
+ * @brief Multi-level BOM explosion into flat leaf-component requirements
+ */
+
+#ifndef BOM_EXPLOSION_H
+#define BOM_EXPLOSION_H
+
+/******************************Project Headers*****************************************/
+#include "Product.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <map>
+#include <vector>
+/*************************************************************************************/
+
+/****************************BomExplosion Class Definition****************************/
+/**
+ * @class BomExplosion
+ * @brief Fills each product's explosion cache from its (possibly nested) BOM
+ *
+ * A BOM entry that names another product is a subassembly: its leaf
+ * components are multiplied in and its assembly time is added per unit.
+ * Every product is expanded once; parents reuse the finished expansion of
+ * their subassemblies (memoized depth-first walk), so the whole catalogue
+ * costs one pass over its BOM lines. A product that contains itself,
+ * directly or through other subassemblies, is rejected.
+ */
+class BomExplosion {
+public:
+    static bool explode(std::map<std::string, Product>& products, std::string& error);
+
+private:
+    enum VisitState { UNVISITED, IN_PROGRESS, DONE };
+
+    static bool expand(const std::string& product_id, std::map<std::string, Product>& products,
+                       std::map<std::string, VisitState>& state, std::vector<std::string>& path,
+                       std::string& error);
+};
+/*************************************************************************************/
+#endif /* BOM_EXPLOSION_H */
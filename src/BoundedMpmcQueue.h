@@ -0,0 +1,106 @@
+/**
+ * @file BoundedMpmcQueue.h
+ * @brief Bounded lock-free multi-producer multi-consumer queue
+ */
+
+#ifndef BOUNDED_MPMC_QUEUE_H
+#define BOUNDED_MPMC_QUEUE_H
+
+/*****************************Standard Libraries***************************************/
+#include <atomic>
+#include <vector>
+#include <cstddef>
+/*************************************************************************************/
+
+/****************************BoundedMpmcQueue Class Definition***********************/
+/**
+ * @class BoundedMpmcQueue
+ * @brief Fixed-capacity ring of cells, each with its own sequence number
+ *
+ * Producers and consumers each claim a position with one compare-and-swap
+ * on their cursor; the cell's sequence number tells whether it is free to
+ * write (seq == pos) or ready to read (seq == pos + 1). No operation takes
+ * a lock or waits for another thread, so a stalled thread never blocks the
+ * others. Capacity is rounded up to a power of two. Meant for small,
+ * trivially copyable values (handles, indices).
+ */
+template <typename T>
+class BoundedMpmcQueue {
+public:
+    explicit BoundedMpmcQueue(size_t min_capacity) : cells(round_up(min_capacity)), mask(cells.size() - 1),
+                                                     enqueue_pos(0), dequeue_pos(0) {
+        for (size_t i = 0; i < cells.size(); ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+    /**
+     * @brief Append a value
+     * @return false if the queue is full
+     */
+    bool try_push(const T& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                                    // Full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the oldest value
+     * @return false if the queue is empty
+     */
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.seq.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                                    // Empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return cells.size(); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    static size_t round_up(size_t n) {
+        size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    std::vector<Cell> cells;
+    const size_t mask;
+    alignas(64) std::atomic<size_t> enqueue_pos;                 // Separate cache lines: producers
+    alignas(64) std::atomic<size_t> dequeue_pos;                 // and consumers do not share one
+};
+/*************************************************************************************/
+#endif /* BOUNDED_MPMC_QUEUE_H */
@@ -0,0 +1,335 @@
+/**
+ * @file ConfigOptimizer.cpp
+ * @brief Configuration search implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "ConfigOptimizer.h"
+#include "QueueingEstimator.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+/*************************************************************************************/
+
+namespace {
+const int LOOKAHEADS[] = { 2, 4, 8, 16 };   // SETUP policy windows searched
+const int FINAL_SURVIVORS = 4;              // Halving stops at this many candidates
+
+const SchedulingPolicy POLICIES[] = { SchedulingPolicy::FIFO, SchedulingPolicy::PRIORITY, SchedulingPolicy::SPT,
+                                      SchedulingPolicy::EDD, SchedulingPolicy::SETUP };
+
+std::string policy_label(SchedulingPolicy policy) {
+    switch (policy) {
+        case SchedulingPolicy::PRIORITY: return "PRIORITY";
+        case SchedulingPolicy::SPT:      return "SPT";
+        case SchedulingPolicy::EDD:      return "EDD";
+        case SchedulingPolicy::SETUP:    return "SETUP";
+        case SchedulingPolicy::FIFO:
+        default:                         return "FIFO";
+    }
+}
+
+/**
+ * @brief Objectives of a candidate: simulated means, or its screening estimate before any run
+ *
+ * A candidate that completes no order gets an infinite lead time (its
+ * average over zero orders would otherwise look best).
+ */
+void objectives(const Candidate& c, double& throughput, double& lead_time) {
+    throughput = c.runs.empty() ? c.screen_throughput : c.summary.throughput.mean;
+    lead_time = c.runs.empty() ? c.screen_lead_time : c.summary.avg_lead_time.mean;
+    if (throughput <= 0.0) lead_time = std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Runs of the full schedule: n candidates once, then halving and doubling down to the final survivors
+ */
+long long schedule_cost(int n) {
+    long long cost = n;
+    int survivors = n;
+    int runs = 1;
+    while (survivors > FINAL_SURVIVORS) {
+        survivors = (survivors + 1) / 2;
+        cost += (long long)survivors * runs;
+        runs *= 2;
+    }
+    return cost;
+}
+}
+
+/****************************Candidate Methods****************************************/
+/**
+ * @brief Short label, e.g. "5 AGVs, SETUP (look-ahead 8)"
+ */
+std::string Candidate::describe() const {
+    std::string label = std::to_string(num_agvs) + (num_agvs == 1 ? " AGV, " : " AGVs, ") + policy_label(policy);
+    if (policy == SchedulingPolicy::SETUP) label += " (look-ahead " + std::to_string(lookahead) + ")";
+    return label;
+}
+/*************************************************************************************/
+
+/****************************ConfigOptimizer Methods**********************************/
+/**
+ * @brief Constructor for ConfigOptimizer
+ * @param orders Order book (copied for each run)
+ * @param products Catalogue with exploded BOMs
+ * @param inventory Initial stock of every run
+ */
+ConfigOptimizer::ConfigOptimizer(const std::vector<Order>& orders,
+                                 const std::map<std::string, Product>& products,
+                                 const std::map<std::string, int>& inventory)
+    : orders(orders), products(products), inventory(inventory), threads(0), max_agvs(20) {
+}
+
+
+/**
+ * @brief Every (AGVs, policy, look-ahead) configuration with its analytical screening estimate
+ *
+ * With vehicle types the fleet is fixed by the profile, so only the
+ * policies are searched.
+ */
+std::vector<Candidate> ConfigOptimizer::search_space(const SimulationConfig& base) const {
+    int low = base.fleet ? base.num_agvs : 1;
+    int high = base.fleet ? base.num_agvs : std::max(1, max_agvs);
+    std::vector<Candidate> space;
+    for (int agvs = low; agvs <= high; ++agvs) {
+        SimulationConfig config = base;
+        config.num_agvs = agvs;
+        QueueingEstimate estimate = QueueingEstimator(config).estimate(orders, products);   // Policy-independent
+        for (SchedulingPolicy policy : POLICIES) {
+            for (int lookahead : LOOKAHEADS) {
+                Candidate c;
+                c.num_agvs = agvs;
+                c.policy = policy;
+                c.lookahead = policy == SchedulingPolicy::SETUP ? lookahead : 0;
+                c.screen_lead_time = estimate.avg_lead_time;
+                c.screen_throughput = estimate.throughput;
+                space.push_back(c);
+                if (policy != SchedulingPolicy::SETUP) break;
+            }
+        }
+    }
+    return space;
+}
+
+
+/**
+ * @brief Bring every candidate of the batch up to `replications` runs, in parallel
+ * @return Runs simulated (cached runs are kept)
+ */
+int ConfigOptimizer::simulate(const SimulationConfig& base, const std::vector<Candidate*>& batch,
+                              int replications) const {
+    std::vector<std::pair<Candidate*, int> > jobs;
+    for (Candidate* c : batch) {
+        for (int r = (int)c->runs.size(); r < replications; ++r) jobs.push_back(std::make_pair(c, r));
+        c->runs.resize(std::max((int)c->runs.size(), replications));
+    }
+    if (jobs.empty()) return 0;
+
+    int workers = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+    workers = std::max(1, std::min(workers, (int)jobs.size()));
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        size_t j;
+        while ((j = next.fetch_add(1)) < jobs.size()) {
+            Candidate* c = jobs[j].first;
+            int r = jobs[j].second;
+            SimulationConfig config = base;
+            config.num_agvs = c->num_agvs;
+            config.policy = c->policy;
+            if (c->policy == SchedulingPolicy::SETUP) config.lookahead = c->lookahead;
+            config.seed = ReplicationRunner::replication_seed(base.seed, r);
+            config.diag_logging = false;
+            std::vector<Order> order_book = orders;
+            DiscreteEventSimulator simulator(config);
+            c->runs[r] = simulator.run(order_book, products, inventory);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; ++w) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    for (Candidate* c : batch) c->summary = ReplicationRunner::summarize(c->runs);
+    return (int)jobs.size();
+}
+
+
+/**
+ * @brief a is no worse than b in throughput, fleet size and lead time, and better in one
+ */
+bool ConfigOptimizer::dominates(const Candidate& a, const Candidate& b) {
+    double a_tp, a_lead, b_tp, b_lead;
+    objectives(a, a_tp, a_lead);
+    objectives(b, b_tp, b_lead);
+    if (a_tp < b_tp || a.num_agvs > b.num_agvs || a_lead > b_lead) return false;
+    return a_tp > b_tp || a.num_agvs < b.num_agvs || a_lead < b_lead;
+}
+
+
+/**
+ * @brief Non-dominated sorting with crowding distances; sorts best first
+ */
+void ConfigOptimizer::rank(std::vector<Candidate*>& candidates) {
+    size_t n = candidates.size();
+    std::vector<int> dominated_by(n, 0);
+    std::vector<std::vector<size_t> > dominates_list(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (i != j && dominates(*candidates[i], *candidates[j])) {
+                dominates_list[i].push_back(j);
+                dominated_by[j]++;
+            }
+        }
+    }
+
+    std::vector<size_t> current;
+    for (size_t i = 0; i < n; ++i) {
+        if (dominated_by[i] == 0) current.push_back(i);
+    }
+    for (int front = 0; !current.empty(); ++front) {
+        // Crowding: normalized gap between the neighbors along each objective
+        for (size_t i : current) candidates[i]->crowding = 0.0;
+        for (int objective = 0; objective < 3; ++objective) {
+            auto value = [&](size_t i) {
+                double tp, lead;
+                objectives(*candidates[i], tp, lead);
+                return objective == 0 ? tp : objective == 1 ? (double)candidates[i]->num_agvs : lead;
+            };
+            std::vector<size_t> order = current;
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return value(a) < value(b); });
+            double span = value(order.back()) - value(order.front());
+            candidates[order.front()]->crowding = std::numeric_limits<double>::infinity();
+            candidates[order.back()]->crowding = std::numeric_limits<double>::infinity();
+            if (!(span > 0.0) || !std::isfinite(span)) continue;
+            for (size_t k = 1; k + 1 < order.size(); ++k) {
+                candidates[order[k]]->crowding += (value(order[k + 1]) - value(order[k - 1])) / span;
+            }
+        }
+
+        std::vector<size_t> next;
+        for (size_t i : current) {
+            candidates[i]->rank = front;
+            for (size_t j : dominates_list[i]) {
+                if (--dominated_by[j] == 0) next.push_back(j);
+            }
+        }
+        current.swap(next);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate* a, const Candidate* b) {
+        if (a->rank != b->rank) return a->rank < b->rank;
+        return a->crowding > b->crowding;
+    });
+}
+
+
+/**
+ * @brief Successive halving within `budget` simulation runs
+ * @param base Run configuration (its seed roots every replication)
+ * @param budget Simulation runs allowed
+ */
+OptimizationResult ConfigOptimizer::optimize(const SimulationConfig& base, int budget) const {
+    auto start = std::chrono::steady_clock::now();
+    OptimizationResult result;
+    std::vector<Candidate> space = search_space(base);
+    result.space_size = (int)space.size();
+
+    // First round: the best-screened candidates the budget can carry through every round
+    std::vector<Candidate*> order;
+    for (auto& c : space) order.push_back(&c);
+    rank(order);
+    std::map<int, size_t> fleet_order;   // The screen cannot tell policies apart: keep a fleet's policies together
+    for (size_t k = 0; k < order.size(); ++k) fleet_order.emplace(order[k]->num_agvs, k);
+    std::stable_sort(order.begin(), order.end(), [&fleet_order](const Candidate* a, const Candidate* b) {
+        return fleet_order[a->num_agvs] < fleet_order[b->num_agvs];
+    });
+    bool fixed_times = base.process_times.is_deterministic();
+    int n = std::min((int)order.size(), std::max(1, budget));
+    while (!fixed_times && n > 1 && schedule_cost(n) > budget) n--;
+    std::vector<Candidate*> round(order.begin(), order.begin() + n);
+
+    int runs = 1;
+    result.simulations += simulate(base, round, runs);
+    result.rounds = 1;
+    while (!fixed_times && (int)round.size() > FINAL_SURVIVORS) {
+        rank(round);
+        size_t keep = (round.size() + 1) / 2;
+        if (result.simulations + (long long)keep * runs > budget) break;
+        round.resize(keep);
+        result.reused_runs += (int)keep * runs;
+        runs *= 2;
+        result.simulations += simulate(base, round, runs);
+        result.rounds++;
+    }
+
+    // Pareto front over everything simulated
+    for (const auto& c : space) {
+        if (!c.runs.empty()) result.candidates.push_back(c);
+    }
+    std::vector<Candidate*> evaluated;
+    for (auto& c : result.candidates) evaluated.push_back(&c);
+    rank(evaluated);
+    for (size_t i = 0; i < result.candidates.size(); ++i) {
+        if (result.candidates[i].rank == 0) result.front.push_back((int)i);
+    }
+    std::sort(result.front.begin(), result.front.end(), [&result](int a, int b) {
+        const Candidate& x = result.candidates[a];
+        const Candidate& y = result.candidates[b];
+        if (x.num_agvs != y.num_agvs) return x.num_agvs < y.num_agvs;
+        return x.summary.throughput.mean > y.summary.throughput.mean;
+    });
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+
+/**
+ * @brief Search summary, the Pareto front and every evaluated candidate
+ */
+std::string ConfigOptimizer::format_report(const OptimizationResult& result) {
+    std::stringstream ss;
+    ss << "Search space: " << result.space_size << " configurations\n";
+    ss << "Evaluated: " << result.candidates.size() << " in " << result.rounds << " rounds ("
+       << result.simulations << " simulation runs, " << result.reused_runs << " reused, "
+       << std::fixed << std::setprecision(2) << result.seconds << " s)\n\n";
+
+    auto table = [&ss](const std::vector<const Candidate*>& rows) {
+        ss << std::left << std::setw(36) << "Configuration" << std::right << std::setw(6) << "Runs"
+           << std::setw(14) << "Throughput/h" << std::setw(22) << "Lead time (min)" << std::setw(10) << "Station"
+           << std::setw(8) << "AGV" << "\n";
+        for (const Candidate* c : rows) {
+            const ReplicationSummary& s = c->summary;
+            std::stringstream lead;
+            lead << std::fixed << std::setprecision(1) << s.avg_lead_time.mean;
+            if (s.replications > 1) lead << " +/- " << s.avg_lead_time.half_width;
+            ss << std::left << std::setw(36) << c->describe() << std::right << std::setw(6) << s.replications
+               << std::fixed << std::setprecision(3) << std::setw(14) << s.throughput.mean
+               << std::setw(22) << lead.str() << std::setprecision(1)
+               << std::setw(9) << 100.0 * s.station_utilization.mean << "%"
+               << std::setw(7) << 100.0 * s.agv_utilization.mean << "%\n";
+        }
+    };
+
+    ss << "Pareto front (throughput up, fleet size down, lead time down):\n";
+    std::vector<const Candidate*> front;
+    for (int i : result.front) front.push_back(&result.candidates[i]);
+    table(front);
+
+    ss << "\nAll evaluated candidates:\n";
+    std::vector<const Candidate*> all;
+    for (const auto& c : result.candidates) all.push_back(&c);
+    std::stable_sort(all.begin(), all.end(), [](const Candidate* a, const Candidate* b) {
+        if (a->rank != b->rank) return a->rank < b->rank;
+        return a->num_agvs < b->num_agvs;
+    });
+    table(all);
+    return ss.str();
+}
+/*************************************************************************************/
@@ -0,0 +1,101 @@
+/**
+ * @file ConfigOptimizer.h
+ * @brief Search over fleet size and scheduling policy for the throughput / fleet cost / lead time Pareto front
+ */
+
+#ifndef CONFIG_OPTIMIZER_H
+#define CONFIG_OPTIMIZER_H
+
+/******************************Project Headers*****************************************/
+#include "Order.h"
+#include "Product.h"
+#include "DiscreteEventSimulator.h"
+#include "ReplicationRunner.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+/*************************************************************************************/
+
+/****************************Optimizer Structures*************************************/
+/**
+ * @struct Candidate
+ * @brief One configuration of the search space and its simulation runs
+ */
+struct Candidate {
+    int num_agvs;                        // Fleet cost
+    SchedulingPolicy policy;
+    int lookahead;                       // SETUP policy window (0 for the other policies)
+    double screen_lead_time;             // Analytical estimate used to pick the first round
+    double screen_throughput;
+    std::vector<SimulationResult> runs;  // Run r used replication_seed(seed, r)
+    ReplicationSummary summary;          // Over all runs so far
+    int rank;                            // Pareto front index among its round (0: non-dominated)
+    double crowding;                     // Spread on its front (larger is kept first)
+
+    Candidate() : num_agvs(0), policy(SchedulingPolicy::FIFO), lookahead(0), screen_lead_time(0.0),
+                  screen_throughput(0.0), rank(0), crowding(0.0) {}
+    std::string describe() const;
+};
+
+/**
+ * @struct OptimizationResult
+ * @brief Every evaluated candidate and the Pareto front among them
+ */
+struct OptimizationResult {
+    std::vector<Candidate> candidates;   // Evaluated configurations
+    std::vector<int> front;              // Non-dominated candidates, by fleet size
+    int space_size;                      // Configurations in the search space
+    int rounds;                          // Successive-halving rounds run
+    int simulations;                     // Simulation runs executed
+    int reused_runs;                     // Runs taken from the cache instead of re-simulated
+    double seconds;                      // Wall-clock time of the search
+
+    OptimizationResult() : space_size(0), rounds(0), simulations(0), reused_runs(0), seconds(0.0) {}
+};
+/*************************************************************************************/
+
+/****************************ConfigOptimizer Class Definition*************************/
+/**
+ * @class ConfigOptimizer
+ * @brief Successive halving over (AGVs, policy, look-ahead) with a budget of simulation runs
+ *
+ * The whole space is first screened with the analytical QueueingEstimator,
+ * which costs microseconds per configuration. The first round simulates as
+ * many of the best-screened candidates as the budget allows, one run each.
+ * Each following round keeps the better half by Pareto rank (throughput up,
+ * fleet size and lead time down; crowding distance breaks ties so the
+ * extremes of the front survive) and doubles its runs. Runs are cached per
+ * candidate, so a survivor only simulates its new replications, and all
+ * candidates share the seeds of replication r (common random numbers).
+ * With fixed process times every seed gives the same run, so each
+ * candidate is simulated once and the budget goes to more candidates.
+ * The runs of one round execute in parallel.
+ */
+class ConfigOptimizer {
+public:
+    ConfigOptimizer(const std::vector<Order>& orders,
+                    const std::map<std::string, Product>& products,
+                    const std::map<std::string, int>& inventory);
+
+    void set_threads(int n) { threads = n; }
+    void set_max_agvs(int n) { max_agvs = n; }
+    OptimizationResult optimize(const SimulationConfig& base, int budget) const;
+    static std::string format_report(const OptimizationResult& result);
+
+private:
+    const std::vector<Order>& orders;
+    const std::map<std::string, Product>& products;
+    const std::map<std::string, int>& inventory;
+    int threads;                         // 0 = hardware concurrency
+    int max_agvs;                        // Fleet sizes searched: 1..max_agvs
+
+    std::vector<Candidate> search_space(const SimulationConfig& base) const;
+    int simulate(const SimulationConfig& base, const std::vector<Candidate*>& batch, int replications) const;
+    static bool dominates(const Candidate& a, const Candidate& b);
+    static void rank(std::vector<Candidate*>& candidates);
+};
+/*************************************************************************************/
+#endif /* CONFIG_OPTIMIZER_H */
@@ -8,6 +8,8 @@
 #include "FileHandler.h"
 #include "AssemblyStation.h"
 #include "AGV.h"
+#include "SimClock.h"
+#include "DiscreteEventSimulator.h"
 /**************************************************************************************/
 
 #include <iostream>
@@ -16,20 +18,30 @@
 #include <iomanip>
 #include <thread>
 #include <chrono>
+#include <limits>
 
 using std::cout;
 using std::endl;
 using std::stringstream;
 
+namespace {
+// Upper bound (wall clock) on waiting for in-flight AGV tasks at shutdown
+const int DRAIN_TIMEOUT_MS = 20000;
+}
+
 ControlCenter::ControlCenter()
-    : policy(SchedulingPolicy::FIFO),
+    : assembly_station(nullptr),
+      agv_fleet(nullptr),
+      warehouse(nullptr),
+      policy(SchedulingPolicy::FIFO),
       current_sim_time_minutes(0),
       simulation_running(false),
       has_stopped(false),
-      assembly_station(nullptr),
       completed_orders(0),
       scheduler_done(false),
-      enable_diag_logs(true) {
+      enable_diag_logs(true),
+      kpi_window_minutes(0),
+      kpi_tracked_skus(5) {
     log_file.open("output/sim_log.txt", std::ios::out);
     if (log_file.is_open()) {
         log_file << "=== Simulation Log ===\n\n";
@@ -37,7 +49,8 @@ ControlCenter::ControlCenter()
 }
 
 ControlCenter::~ControlCenter() {
-    if (!has_stopped.load()) {
+    // Only a started threaded simulation has anything to stop
+    if (!has_stopped.load() && scheduler_thread.joinable()) {
         stop_simulation();
     }
     if (log_file.is_open()) {
@@ -53,17 +66,90 @@ bool ControlCenter::load_bom(const std::string& filename) {
     return FileHandler::read_bom_file(filename, products);
 }
 
-bool ControlCenter::load_warehouse(const std::string& filename, Warehouse* warehouse) {
+bool ControlCenter::load_warehouse(const std::string& filename, Warehouse* wh) {
     std::map<std::string, int> inventory;
     if (!FileHandler::read_warehouse_file(filename, inventory)) {
         return false;
     }
     for (const auto& item : inventory) {
-        warehouse->add_component(item.first, item.second);
+        wh->add_component(item.first, item.second);
+        initial_inventory[item.first] += item.second;
     }
+    warehouse = wh;
     return true;
 }
 
+bool ControlCenter::load_layout(const std::string& filename) {
+    return FileHandler::read_layout_file(filename, layout);
+}
+
+/**
+ * @brief Load vehicle types and check that every product and component has a carrier
+ * @param filename Path to the fleet file (load the BOM first)
+ * @return true if the fleet can move every item, false otherwise
+ */
+bool ControlCenter::load_fleet(const std::string& filename) {
+    if (!FileHandler::read_fleet_file(filename, fleet_profile)) return false;
+    bool ok = true;
+    for (const auto& product : products) {
+        if (fleet_profile.capability_mask(product.first) == 0) {
+            std::cerr << "Error: no vehicle type in " << filename << " can carry product " << product.first << std::endl;
+            ok = false;
+        }
+        for (const auto& comp : product.second.leaf_requirements) {
+            if (fleet_profile.capability_mask(comp.component_id) == 0) {
+                std::cerr << "Error: no vehicle type in " << filename << " can carry component " << comp.component_id << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Load sequence-dependent setup times (flat T_setup without them)
+ * @param filename Path to the setup file
+ * @return true if successful, false otherwise
+ */
+bool ControlCenter::load_setup_matrix(const std::string& filename) {
+    return FileHandler::read_setup_file(filename, setup_matrix);
+}
+
+/**
+ * @brief Load workcenters and product routings (load the BOM first)
+ * @param filename Path to the routing file
+ * @return true if successful, false otherwise
+ */
+bool ControlCenter::load_routing(const std::string& filename) {
+    return FileHandler::read_routing_file(filename, products, workcenters);
+}
+
+/**
+ * @brief Pre-run MRP pass: forecast shortages and cancel orders that can never be built
+ * @param skip_unbuildable Cancel orders the initial stock cannot cover (they stay in the book, unreleased)
+ * @param threads Worker threads for the demand reduction (0 = all cores)
+ * @return The material plan (also written to output/mrp_report.txt)
+ */
+MaterialPlan ControlCenter::plan_materials(bool skip_unbuildable, int threads) {
+    MaterialPlanner planner(orders, products, initial_inventory);
+    planner.set_threads(threads);
+    MaterialPlan plan = planner.plan();
+    FileHandler::write_mrp_report("output/mrp_report.txt", plan);
+    if (!skip_unbuildable || plan.unbuildable_orders == 0) return plan;
+
+    for (const auto& s : plan.shortages) {
+        if (!s.unbuildable) continue;
+        orders[s.order_index].is_canceled = true;
+        orders[s.order_index].is_unbuildable = true;
+        stringstream msg;
+        msg << "Order skipped (MRP): " << s.product_id << " (ID: " << s.order_id << ", release "
+            << format_time(s.release_minutes) << ")";
+        if (!s.component_id.empty()) msg << ", needs " << s.required << " " << s.component_id << ", stock " << s.available;
+        log_event(msg.str());
+    }
+    return plan;
+}
+
 void ControlCenter::start_simulation(AssemblyStation* station, std::vector<AGV*>* fleet) {
     assembly_station = station;
     agv_fleet = fleet;
@@ -72,11 +158,38 @@ void ControlCenter::start_simulation(AssemblyStation* station, std::vector<AGV*>
         assembly_station->set_products(&products);
         assembly_station->set_control_center(this);
         assembly_station->set_simulation_time(current_sim_time_minutes.load());
+        assembly_station->set_setup_matrix(get_setup_matrix());
+    }
+
+    // With a layout or vehicle types, dispatch goes to the nearest (fastest) capable idle AGV
+    const FleetProfile* profile = get_fleet_profile();
+    if ((get_layout() || profile) && agv_fleet) {
+        fleet_index.reset(new FleetIndex(get_layout()));
+        fleet_index->reset((int)agv_fleet->size());
+        if (profile) {
+            std::vector<int> slot_types;
+            for (size_t k = 0; k < agv_fleet->size(); ++k) {
+                slot_types.push_back(k < (size_t)profile->fleet_size() ? profile->type_of_slot((int)k) : 0);
+            }
+            fleet_index->set_vehicle_types(slot_types, profile->speeds());
+        }
+        if (assembly_station) assembly_station->set_fleet_index(fleet_index.get(), get_layout(), profile);
     }
 
     if (agv_fleet) {
-        for (auto* agv : *agv_fleet) {
-            if (agv) agv->start();
+        for (size_t k = 0; k < agv_fleet->size(); ++k) {
+            AGV* agv = (*agv_fleet)[k];
+            if (agv) {
+                if (profile && k < (size_t)profile->fleet_size()) {
+                    int t = profile->type_of_slot((int)k);
+                    const VehicleType& type = profile->get_type(t);
+                    agv->set_vehicle_type(type.name, t, type.speed_factor);
+                }
+                agv->set_layout(get_layout());
+                agv->set_fleet_index(fleet_index.get(), (int)k);
+                agv->set_task_latch(&task_latch);
+                agv->start();
+            }
         }
     }
 
@@ -87,6 +200,9 @@ void ControlCenter::start_simulation(AssemblyStation* station, std::vector<AGV*>
     simulation_running = true;
     has_stopped = false;
     completed_orders = 0;
+    for (const auto& order : orders) {
+        if (order.is_unbuildable) completed_orders.fetch_add(1);   // Settled by the MRP pass
+    }
     scheduler_done = false;
 
     if (policy == SchedulingPolicy::FIFO) {
@@ -100,6 +216,8 @@ void ControlCenter::start_simulation(AssemblyStation* station, std::vector<AGV*>
             });
     }
 
+    if (kpi_window_minutes > 0) { open_kpi_series(); }
+
     scheduler_thread = std::thread(&ControlCenter::scheduler_loop, this);
     log_event("Simulation started");
 }
@@ -110,17 +228,28 @@ void ControlCenter::stop_simulation() {
     simulation_running = false;
     if (scheduler_thread.joinable()) { scheduler_thread.join(); }
 
-    if (assembly_station) { assembly_station->stop(); }
+    if (assembly_station) {
+        assembly_station->stop();
+        OrderQueueStats q = assembly_station->get_queue_stats();
+        log_event("[Diag] order queue: " + std::to_string(q.pushed) + " orders queued, peak depth " + std::to_string(q.peak_depth)
+                  + ", " + std::to_string(q.full_waits) + " waits for a free slot");
+    }
 
+    // Drain: let in-flight transports (e.g. finished-product returns) finish, then stop and join the fleet
     if (agv_fleet) {
-        bool all_idle = false; int spin = 0;
-        while (!all_idle && spin < 200) {
-            all_idle = true;
-            for (auto* agv : *agv_fleet) { if (agv && !agv->is_idle()) { all_idle = false; break; } }
-            if (!all_idle) std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            ++spin;
+        if (!task_latch.wait_idle(std::chrono::milliseconds(DRAIN_TIMEOUT_MS))) {
+            log_event("[Diag] shutdown drain timed out with " + std::to_string(task_latch.count()) + " AGV tasks in flight");
         }
         for (auto* agv : *agv_fleet) { if (agv) agv->stop(); }
+        for (auto* agv : *agv_fleet) { if (agv) agv->join(); }
+    }
+
+    if (kpi_series.is_open()) {
+        int end_time = current_sim_time_minutes.load();
+        for (const auto& order : orders) {
+            if (order.is_completed) end_time = std::max(end_time, order.completion_time_minutes);
+        }
+        kpi_series.finish(end_time);
     }
 
     compute_kpis();
@@ -128,6 +257,47 @@ void ControlCenter::stop_simulation() {
     log_event("Simulation stopped");
 }
 
+SimulationResult ControlCenter::run_deterministic(SimulationConfig config) {
+    has_stopped = true;  // Nothing to stop: no threads are started in this mode
+    config.diag_logging = enable_diag_logs;
+
+    DiscreteEventSimulator simulator(config);
+    simulator.set_logger([this](double time, const std::string& message) {
+        current_sim_time_minutes = (int)time;
+        log_event(message);
+    });
+    if (kpi_window_minutes > 0) {
+        std::vector<std::string> skus = top_demand_skus();
+        simulator.set_time_series(&kpi_series, skus);
+        kpi_series.open(kpi_series_path, kpi_window_minutes, first_release_time(), skus);
+    }
+
+    log_event("Simulation started (deterministic mode)");
+    SimulationResult result = simulator.run(orders, products, initial_inventory);
+    completed_orders = result.completed_orders + result.canceled_orders;
+
+    if (enable_diag_logs) {
+        std::stringstream diag;
+        diag << "[Diag] totals: total_agv_busy_time=" << result.agv_busy_minutes
+             << ", num_agvs=" << config.num_agvs
+             << ", total_sim_time=" << result.makespan_minutes
+             << ", station_busy_time=" << result.station_busy_minutes
+             << ", completed_count=" << result.completed_orders
+             << ", canceled_count=" << result.canceled_orders
+             << ", events=" << result.events_processed;
+        log_event(diag.str());
+    }
+    std::stringstream hash;
+    hash << "Event trace hash: 0x" << std::hex << std::setw(16) << std::setfill('0') << result.trace_hash;
+    log_event(hash.str());
+
+    write_kpi_report(result.avg_lead_time, result.station_utilization, result.throughput, result.agv_utilization);
+    FileHandler::write_agv_report("output/agv_report.txt", result.agv_stats);
+    log_event("KPIs computed and saved");
+    log_event("Simulation stopped");
+    return result;
+}
+
 void ControlCenter::wait_until_all_orders_complete() {
     std::unique_lock<std::mutex> lk(completion_mutex);
     completion_cv.wait(lk, [this]{
@@ -139,62 +309,187 @@ void ControlCenter::scheduler_loop() {
     int sim_start_time = 0;
     current_sim_time_minutes = sim_start_time;
 
-    for (auto& order : orders) {
+    std::vector<Lot> lots;
+    for (size_t i = 0; i < orders.size(); ++i) {
+        const Order& order = orders[i];
         if (!simulation_running) break;
+        if (order.is_unbuildable) continue;
         current_sim_time_minutes = order.release_time_minutes;
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        release_order(order);
+        SimClock::sleep_ms(100);
+        lots.clear();
+        if (lot_batcher.enabled()) lot_batcher.close_expired(order.release_time_minutes, lots);
+        for (const Lot& lot : lots) release_lot(lot, (int)(lot.opened_minutes + lot_batcher.window()));
+        release_order(order, (int)i);
+    }
+
+    // Lots still open when the order book ends close at the end of their window
+    lots.clear();
+    lot_batcher.close_all(lots);
+    for (const Lot& lot : lots) {
+        if (simulation_running) release_lot(lot, (int)(lot.opened_minutes + lot_batcher.window()));
     }
 
     scheduler_done = true;
     completion_cv.notify_all();
 }
 
-void ControlCenter::release_order(const Order& order) {
+void ControlCenter::release_order(const Order& order, int index) {
     std::stringstream msg;
     msg << format_time(order.release_time_minutes) 
         << " Order released: " << order.product_id 
         << " (Priority: " << order.priority << ", ID: " << order.order_id << ")";
     log_event(msg.str());
 
+    kpi_series.advance_to(order.release_time_minutes);
+
+    if (lot_batcher.enabled()) {
+        Lot full;
+        int carry_limit = get_fleet_profile() ? get_fleet_profile()->max_units(order.product_id) : 0;
+        if (lot_batcher.add(order.product_id, index, order.release_time_minutes, full, carry_limit)) {
+            release_lot(full, order.release_time_minutes);
+        }
+        return;
+    }
+
     if (assembly_station) {
         assembly_station->set_simulation_time(current_sim_time_minutes.load());
         assembly_station->add_order(order);
     }
 }
 
+/**
+ * @brief Send a closed lot to the station as its first order
+ * @param lot Order indices of the lot
+ * @param release_time_minutes When the lot closed (its earliest start)
+ *
+ * The station reserves, moves and assembles the lot as one job with one
+ * setup; completion and cancellation are reported per order through
+ * lot_members.
+ */
+void ControlCenter::release_lot(const Lot& lot, int release_time_minutes) {
+    Order lead = orders[lot.members.front()];
+    lead.lot_size = (int)lot.members.size();
+    lead.release_time_minutes = std::max(lead.release_time_minutes, release_time_minutes);
+
+    if (lead.lot_size > 1) {
+        std::vector<int> ids;
+        std::stringstream msg;
+        msg << format_time(lead.release_time_minutes) << " Lot released: " << lead.product_id
+            << " x" << lead.lot_size << " (IDs";
+        for (int index : lot.members) {
+            ids.push_back(orders[index].order_id);
+            msg << " " << orders[index].order_id;
+        }
+        msg << ")";
+        {
+            std::lock_guard<std::mutex> lk(lot_mutex);
+            lot_members[lead.order_id] = ids;
+        }
+        log_event(msg.str());
+    }
+
+    if (assembly_station) {
+        assembly_station->set_simulation_time(current_sim_time_minutes.load());
+        assembly_station->add_order(lead);
+    }
+}
+
+/**
+ * @brief IDs of the orders that complete or cancel together with an order
+ */
+std::vector<int> ControlCenter::lot_of(int order_id) {
+    std::lock_guard<std::mutex> lk(lot_mutex);
+    auto it = lot_members.find(order_id);
+    return it != lot_members.end() ? it->second : std::vector<int>(1, order_id);
+}
+
 void ControlCenter::mark_order_completed(int order_id, int completion_time_minutes) {
-    for (auto& order : orders) {
-        if (order.order_id == order_id) {
-            order.is_completed = true; order.completion_time_minutes = completion_time_minutes;
-            {
-                std::lock_guard<std::mutex> lk(completion_mutex);
-                completed_orders.fetch_add(1);
+    for (int member_id : lot_of(order_id)) {
+        for (auto& order : orders) {
+            if (order.order_id == member_id) {
+                order.is_completed = true; order.completion_time_minutes = completion_time_minutes;
+                kpi_series.record_completion(completion_time_minutes);
+                {
+                    std::lock_guard<std::mutex> lk(completion_mutex);
+                    completed_orders.fetch_add(1);
+                }
+                completion_cv.notify_all();
+                std::stringstream msg; msg << format_time(completion_time_minutes) << " Order completed: " << order.product_id << " (ID: " << member_id << ")"; log_event(msg.str());
+                break;
             }
-            completion_cv.notify_all();
-            std::stringstream msg; msg << format_time(completion_time_minutes) << " Order completed: " << order.product_id << " (ID: " << order_id << ")"; log_event(msg.str());
-            break;
         }
     }
 }
 
 void ControlCenter::mark_order_canceled(int order_id) {
-    for (auto& order : orders) {
-        if (order.order_id == order_id) {
-            order.is_canceled = true;
-            {
-                std::lock_guard<std::mutex> lk(completion_mutex);
-                completed_orders.fetch_add(1);
+    for (int member_id : lot_of(order_id)) {
+        for (auto& order : orders) {
+            if (order.order_id == member_id) {
+                order.is_canceled = true;
+                {
+                    std::lock_guard<std::mutex> lk(completion_mutex);
+                    completed_orders.fetch_add(1);
+                }
+                completion_cv.notify_all();
+                std::stringstream msg; msg << format_time(current_sim_time_minutes.load())
+                    << " Order canceled: " << order.product_id << " (ID: " << member_id << ")";
+                log_event(msg.str());
+                break;
             }
-            completion_cv.notify_all();
-            std::stringstream msg; msg << format_time(current_sim_time_minutes.load())
-                << " Order canceled: " << order.product_id << " (ID: " << order_id << ")";
-            log_event(msg.str());
-            break;
         }
     }
 }
 
+void ControlCenter::record_station_busy(int start_minutes, int end_minutes) {
+    kpi_series.record_station_busy(start_minutes, end_minutes);
+}
+
+std::vector<std::string> ControlCenter::top_demand_skus() const {
+    // Track the SKUs with the highest total demand across the order book
+    std::map<std::string, long long> demand;
+    for (const auto& order : orders) {
+        if (order.is_unbuildable) continue;
+        auto it = products.find(order.product_id);
+        if (it == products.end()) continue;
+        for (const auto& comp : it->second.leaf_requirements) { demand[comp.component_id] += comp.quantity; }
+    }
+    std::vector<std::pair<std::string, long long> > ranked(demand.begin(), demand.end());
+    std::stable_sort(ranked.begin(), ranked.end(),
+        [](const std::pair<std::string, long long>& a, const std::pair<std::string, long long>& b) { return a.second > b.second; });
+    if ((int)ranked.size() > kpi_tracked_skus) ranked.resize(kpi_tracked_skus);
+
+    std::vector<std::string> skus;
+    for (const auto& r : ranked) skus.push_back(r.first);
+    return skus;
+}
+
+int ControlCenter::first_release_time() const {
+    int start = std::numeric_limits<int>::max();
+    for (const auto& order : orders) {
+        if (!order.is_unbuildable) start = std::min(start, order.release_time_minutes);
+    }
+    return start == std::numeric_limits<int>::max() ? 0 : start;
+}
+
+void ControlCenter::open_kpi_series() {
+    std::vector<std::string> skus = top_demand_skus();
+    kpi_series.set_sampler([this, skus](KpiSample& sample) {
+        sample.queue_length = assembly_station ? assembly_station->get_queue_length() : 0;
+        sample.station_slots = assembly_station ? assembly_station->get_capacity() : 1;
+        if (agv_fleet) {
+            sample.num_agvs = (int)agv_fleet->size();
+            for (auto* agv : *agv_fleet) {
+                if (!agv->is_idle()) sample.agvs_busy++;
+                sample.agv_busy_minutes_total += agv->busy_time_minutes.load();
+            }
+        }
+        for (const auto& sku : skus) {
+            sample.stock.push_back(warehouse ? warehouse->get_component_quantity(sku) : 0);
+        }
+    });
+    kpi_series.open(kpi_series_path, kpi_window_minutes, first_release_time(), skus);
+}
+
 void ControlCenter::compute_kpis() {
     if (orders.empty()) return;
 
@@ -210,12 +505,16 @@ void ControlCenter::compute_kpis() {
     }
 
     double avg_lead_time = (completed_count > 0) ? (total_lead_time / completed_count) : 0.0;
-    int first_release_time = orders.empty() ? 0 : orders[0].release_time_minutes;
+    int first_release_time = 0;
+    for (const auto& order : orders) {
+        if (!order.is_unbuildable) { first_release_time = order.release_time_minutes; break; }
+    }
     int total_sim_time = max_completion_time - first_release_time;
     if (total_sim_time <= 0) { total_sim_time = current_sim_time_minutes.load(); if (total_sim_time <= 0) total_sim_time = 1; }
 
     int station_busy_time = assembly_station ? assembly_station->get_total_busy_time() : 0;
-    double station_utilization = (double)station_busy_time / total_sim_time;
+    int station_slots = assembly_station ? assembly_station->get_capacity() : 1;
+    double station_utilization = (double)station_busy_time / (station_slots * total_sim_time);   // Slot-minutes used / available
     double throughput = (completed_count * 60.0) / total_sim_time;
 
     int total_agv_busy_time = 0; int num_agvs = (agv_fleet) ? (int)agv_fleet->size() : 1;
@@ -228,6 +527,7 @@ void ControlCenter::compute_kpis() {
              << ", num_agvs=" << num_agvs
              << ", total_sim_time=" << total_sim_time
              << ", station_busy_time=" << station_busy_time
+             << ", station_setup_time=" << (assembly_station ? assembly_station->get_total_setup_time() : 0)
              << ", completed_count=" << completed_count
              << ", canceled_count=" << canceled_count;
         log_event(diag.str());
@@ -243,6 +543,21 @@ void ControlCenter::compute_kpis() {
     }
 
     write_kpi_report(avg_lead_time, station_utilization, throughput, agv_utilization);
+
+    std::vector<AgvStatistics> agv_stats;
+    if (agv_fleet) {
+        for (auto* agv : *agv_fleet) {
+            AgvStatistics stats;
+            stats.agv_id = agv->get_id();
+            stats.operations = agv->total_operations.load();
+            stats.busy_minutes = agv->busy_time_minutes.load();
+            stats.empty_km = agv->empty_distance_m.load() / 1000.0;
+            stats.loaded_km = agv->loaded_distance_m.load() / 1000.0;
+            stats.vehicle_type = agv->get_vehicle_type();
+            agv_stats.push_back(stats);
+        }
+    }
+    FileHandler::write_agv_report("output/agv_report.txt", agv_stats);
 }
 
 void ControlCenter::write_kpi_report(double avg_lead_time, double station_utilization, double throughput, double agv_utilization) {
@@ -10,15 +10,25 @@
 #include "Order.h"
 #include "Product.h"
 #include "Warehouse.h"
-
+#include "KpiTimeSeries.h"
+#include "Layout.h"
+#include "FleetIndex.h"
+#include "FleetProfile.h"
+#include "SetupMatrix.h"
+#include "LotBatcher.h"
+#include "TaskLatch.h"
+#include "MaterialPlanner.h"
 /**************************************************************************************/
 
 /*****************************Standard Libraries***************************************/
 // Forward declarations
 class AssemblyStation;
 class AGV;
+struct SimulationConfig;
+struct SimulationResult;
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <atomic>
@@ -35,7 +45,8 @@ enum class SchedulingPolicy {
     FIFO,
     PRIORITY,
     SPT,
-    EDD
+    EDD,
+    SETUP       // Least changeover within a look-ahead window, due dates permitting
 };
 
 /**
@@ -48,6 +59,19 @@ private:
     std::map<std::string, Product> products;
     AssemblyStation* assembly_station;
     std::vector<AGV*>* agv_fleet;
+    Warehouse* warehouse;
+    std::map<std::string, int> initial_inventory;  // Stock as loaded (for deterministic runs)
+    Layout layout;                                 // Optional shop-floor graph
+    std::unique_ptr<FleetIndex> fleet_index;       // Idle AGVs by position and type (layout or fleet profile)
+    FleetProfile fleet_profile;                    // Optional vehicle types
+    SetupMatrix setup_matrix;                      // Optional sequence-dependent setup times
+    std::vector<Workcenter> workcenters;           // Optional downstream workcenters (product routings)
+    TaskLatch task_latch;                          // AGV tasks in flight (shutdown drain)
+
+    // Lot batching: a lot reaches the station as its first order with lot_size set
+    LotBatcher lot_batcher;
+    std::mutex lot_mutex;
+    std::map<int, std::vector<int> > lot_members;  // Lead order ID -> IDs of every order in its lot
     
     SchedulingPolicy policy;
     std::atomic<int> current_sim_time_minutes;
@@ -65,8 +89,19 @@ private:
 
     bool enable_diag_logs;
 
+    // Time-windowed KPI export
+    KpiTimeSeries kpi_series;
+    int kpi_window_minutes;   // 0 disables the time series
+    int kpi_tracked_skus;     // Number of most-demanded SKUs whose stock is reported
+    std::string kpi_series_path;
+    void open_kpi_series();
+    std::vector<std::string> top_demand_skus() const;
+    int first_release_time() const;
+
     void scheduler_loop();
-    void release_order(const Order& order);
+    void release_order(const Order& order, int index);
+    void release_lot(const Lot& lot, int release_time_minutes);
+    std::vector<int> lot_of(int order_id);
     void compute_kpis();
     void write_kpi_report(double avg_lead_time,
                           double station_utilization,
@@ -80,10 +115,17 @@ public:
     bool load_orders(const std::string& filename);
     bool load_bom(const std::string& filename);
     bool load_warehouse(const std::string& filename, Warehouse* warehouse);
+    bool load_layout(const std::string& filename);
+    bool load_fleet(const std::string& filename);
+    bool load_setup_matrix(const std::string& filename);
+    bool load_routing(const std::string& filename);
+    MaterialPlan plan_materials(bool skip_unbuildable, int threads);
 
     void start_simulation(AssemblyStation* station, std::vector<AGV*>* fleet);
     void stop_simulation();
+    SimulationResult run_deterministic(SimulationConfig config);
     void set_scheduling_policy(SchedulingPolicy pol) { policy = pol; }
+    void set_lot_batching(int window_minutes, int max_size) { lot_batcher.configure(window_minutes, max_size); }
     
     void mark_order_completed(int order_id, int completion_time_minutes);
     void mark_order_canceled(int order_id);
@@ -91,10 +133,20 @@ public:
     
     std::vector<Order>& get_orders() { return orders; }
     std::map<std::string, Product>& get_products() { return products; }
+    const std::map<std::string, int>& get_initial_inventory() const { return initial_inventory; }
+    const Layout* get_layout() const { return layout.is_built() ? &layout : nullptr; }
+    const FleetProfile* get_fleet_profile() const { return fleet_profile.empty() ? nullptr : &fleet_profile; }
+    const SetupMatrix* get_setup_matrix() const { return setup_matrix.empty() ? nullptr : &setup_matrix; }
+    const std::vector<Workcenter>* get_workcenters() const { return workcenters.empty() ? nullptr : &workcenters; }
     
     int get_simulation_time() const { return current_sim_time_minutes.load(); }
     void set_simulation_time(int minutes) { current_sim_time_minutes = minutes; }
 
+    void set_kpi_window(int minutes, const std::string& path, int tracked_skus = 5) {
+        kpi_window_minutes = minutes; kpi_series_path = path; kpi_tracked_skus = tracked_skus;
+    }
+    void record_station_busy(int start_minutes, int end_minutes);
+
     void log_event(const std::string& message);
     void set_diag_logging(bool enabled) { enable_diag_logs = enabled; }
 };
@@ -0,0 +1,1477 @@
+/**
+ * @file DiscreteEventSimulator.cpp
+ * @brief Deterministic discrete-event model of the assembly cell
+ */
+
+/******************************Project Headers*****************************************/
+#include "DiscreteEventSimulator.h"
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <chrono>
+/*************************************************************************************/
+
+/****************************Trace Hashing*******************************************/
+namespace {
+const uint64_t FNV_OFFSET = 1469598103934665603ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+inline uint64_t fnv_mix(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+}
+/*************************************************************************************/
+
+/**************************DiscreteEventSimulator Methods****************************/
+/**
+ * @brief Constructor for DiscreteEventSimulator
+ * @param cfg Run configuration
+ */
+DiscreteEventSimulator::DiscreteEventSimulator(const SimulationConfig& cfg)
+    : config(cfg),
+      time_series(nullptr),
+      now(0.0),
+      next_seq(0),
+      trace(FNV_OFFSET),
+      events(0),
+      orders(nullptr),
+      warehouse(nullptr),
+      station_retry_wait(false),
+      waiting_slots(0),
+      station_busy(0.0),
+      station_setup(0.0),
+      changeovers(0),
+      lots_started(0),
+      wip_moves(0),
+      idle_vehicles(0),
+      rr_index(0),
+      cycle_scheduled(false),
+      dispatch_cycles(0),
+      cycle_solve_seconds(0.0) {
+}
+
+
+/**
+ * @brief Feed per-window KPIs of the next run into an opened time series
+ * @param series Time series (already opened by the caller)
+ * @param tracked_skus SKUs in the same order as the series header
+ */
+void DiscreteEventSimulator::set_time_series(KpiTimeSeries* series,
+                                             const std::vector<std::string>& tracked_skus) {
+    time_series = series;
+    series_skus = tracked_skus;
+    if (!time_series) return;
+    time_series->set_sampler([this](KpiSample& sample) {
+        sample.queue_length = (int)station_queue.size();
+        sample.station_slots = (int)slots.size();
+        sample.num_agvs = (int)fleet.size();
+        sample.agvs_busy = (int)fleet.size() - idle_vehicles;
+        double busy = 0.0;
+        for (const auto& v : fleet) busy += v.busy_minutes;
+        sample.agv_busy_minutes_total = (long long)busy;
+        for (const auto& sku : series_skus) {
+            sample.stock.push_back(warehouse ? warehouse->get_component_quantity(sku) : 0);
+        }
+    });
+}
+
+
+/**
+ * @brief Run the simulation to completion
+ * @param order_book Orders to simulate; completion/cancel fields are filled in
+ * @param products Product BOMs and base times
+ * @param inventory Initial component stock
+ * @return KPIs and run statistics
+ */
+SimulationResult DiscreteEventSimulator::run(std::vector<Order>& order_book,
+                                             const std::map<std::string, Product>& products,
+                                             const std::map<std::string, int>& inventory) {
+    Warehouse run_warehouse;
+    for (const auto& item : inventory) {
+        run_warehouse.add_component(item.first, item.second);
+    }
+
+    // Reset run state
+    warehouse = &run_warehouse;
+    orders = &order_book;
+    now = 0.0;
+    next_seq = 0;
+    trace = FNV_OFFSET;
+    events = 0;
+    event_queue = decltype(event_queue)();
+    station_queue = decltype(station_queue)();
+    StationSlot free_slot;
+    free_slot.state = SLOT_IDLE;
+    free_slot.order = -1;
+    free_slot.pending_units = 0;
+    free_slot.last_product = nullptr;
+    slots.assign(std::max(config.station_slots, 1), free_slot);
+    station_retry_wait = false;
+    waiting_slots = 0;
+    station_busy = 0.0;
+    station_setup = 0.0;
+    changeovers = 0;
+    retry_counts.assign(order_book.size(), 0);
+    batcher = LotBatcher();
+    batcher.configure(config.lot_window_minutes, config.lot_max_size);
+    lot_members.assign(order_book.size(), std::vector<int>());
+    lots_started = 0;
+    completion_times.assign(order_book.size(), 0.0);
+    transport_queue.clear();
+    outbound.clear();
+    backhaul_trips = 0;
+    charger_node = -1;
+    if (config.layout) {
+        charger_node = config.battery.charger_node.empty() ? config.layout->home_node()
+                                                           : config.layout->find_node(config.battery.charger_node);
+        if (charger_node < 0) charger_node = config.layout->home_node();
+    }
+    chargers_free = config.battery.chargers;
+    opportunity_driving = 0;
+    charger_queue.clear();
+    charger_wait = 0.0;
+    charges = 0;
+    fleet.assign(std::max(config.num_agvs, 0), Vehicle());
+    for (size_t k = 0; k < fleet.size(); ++k) {
+        Vehicle& v = fleet[k];
+        v.state = AGVState::IDLE;
+        v.task_start = 0.0;
+        v.busy_minutes = 0.0;
+        v.congestion_minutes = 0.0;
+        v.empty_m = 0.0;
+        v.loaded_m = 0.0;
+        v.operations = 0;
+        v.location = config.layout ? config.layout->home_node() : -1;
+        v.backhaul = false;
+        v.speed = 1.0;
+        if (config.fleet && (int)k < config.fleet->fleet_size()) {
+            v.speed = config.fleet->get_type(config.fleet->type_of_slot((int)k)).speed_factor;
+        }
+        v.leg_event = 0;
+        v.soc = config.battery.initial;
+        v.min_soc = v.soc;
+        v.charge_phase = CHARGE_DRIVING;
+        v.opportunity_charge = false;
+        v.charge_begin = 0.0;
+        v.plug_time = 0.0;
+        v.charging_minutes = 0.0;
+        for (uint32_t leg = 0; leg < 4; ++leg) {
+            v.leg_streams[leg] = RandomStream(config.seed, RandomStream::stream_id(STREAM_AGV, leg, k));
+        }
+    }
+    idle_vehicles = (int)fleet.size();
+    rr_index = 0;
+    planner.reset();
+    if (config.layout && config.congestion_routing) planner.reset(new RoutePlanner(*config.layout));
+    cycle_scheduled = false;
+    dispatch_cycles = 0;
+    cycle_solve_seconds = 0.0;
+    idle_index.reset();
+    if (config.layout || config.fleet) {
+        idle_index.reset(new FleetIndex(config.layout));
+        idle_index->reset((int)fleet.size());
+        if (config.fleet) {
+            std::vector<int> slot_types;
+            for (size_t k = 0; k < fleet.size(); ++k) {
+                slot_types.push_back((int)k < config.fleet->fleet_size() ? config.fleet->type_of_slot((int)k) : 0);
+            }
+            idle_index->set_vehicle_types(slot_types, config.fleet->speeds());
+        }
+        for (size_t k = 0; k < fleet.size(); ++k) idle_index->add_idle((int)k, fleet[k].location);
+    }
+
+    order_products.assign(order_book.size(), nullptr);
+    for (size_t i = 0; i < order_book.size(); ++i) {
+        Order& order = order_book[i];
+        order.is_completed = false;
+        order.is_canceled = order.is_unbuildable;   // MRP cancellations are never released
+        order.completion_time_minutes = -1;
+        auto it = products.find(order.product_id);
+        if (it != products.end()) order_products[i] = &it->second;
+        if (!order.is_unbuildable) schedule(order.release_time_minutes, ORDER_RELEASE, (int)i);
+    }
+    build_routes(products);
+
+    // Main event loop
+    while (!event_queue.empty()) {
+        Event ev = event_queue.top();
+        event_queue.pop();
+        now = ev.time;
+        events++;
+        trace_event(ev);
+        if (time_series) time_series->advance_to((int)now);
+
+        switch (ev.type) {
+            case ORDER_RELEASE: {
+                const Order& order = order_book[ev.entity];
+                std::stringstream msg;
+                msg << "Order released: " << order.product_id << " (Priority: " << order.priority
+                    << ", ID: " << order.order_id << ")";
+                log(msg.str());
+                if (batcher.enabled()) {
+                    bool opens = !batcher.has_open(order.product_id);
+                    Lot full;
+                    int carry_limit = config.fleet ? config.fleet->max_units(order.product_id) : 0;
+                    if (batcher.add(order.product_id, ev.entity, now, full, carry_limit)) close_lot(full);
+                    else if (opens) schedule(now + batcher.window(), LOT_CLOSE, ev.entity);
+                    break;
+                }
+                enqueue_order(ev.entity);
+                station_try_start();
+                break;
+            }
+            case STATION_RETRY:
+                station_retry_wait = false;
+                station_try_start();
+                break;
+            case STATION_DONE:
+                station_complete(ev.entity);
+                break;
+            case AGV_LEG_DONE:
+                if (ev.seq != fleet[ev.entity].leg_event) break;   // Charge cut short
+                if (fleet[ev.entity].state == AGVState::CHARGING) on_charge_event(ev.entity);
+                else on_leg_done(ev.entity);
+                break;
+            case DISPATCH_CYCLE:
+                run_dispatch_cycle();
+                break;
+            case LOT_CLOSE: {
+                std::vector<Lot> closed;
+                batcher.close_expired(now, closed);
+                for (const Lot& lot : closed) close_lot(lot);
+                break;
+            }
+            case OPERATION_DONE:
+                operation_complete(ev.entity);
+                break;
+        }
+    }
+
+    // KPIs (same definitions as ControlCenter::compute_kpis)
+    SimulationResult result;
+    double total_lead_time = 0.0;
+    double first_release = std::numeric_limits<double>::max();
+    double last_completion = 0.0;
+    for (size_t i = 0; i < order_book.size(); ++i) {
+        const Order& order = order_book[i];
+        if (order.is_unbuildable) { result.canceled_orders++; continue; }
+        first_release = std::min(first_release, (double)order.release_time_minutes);
+        if (order.is_canceled) { result.canceled_orders++; continue; }
+        if (order.is_completed) {
+            result.completed_orders++;
+            total_lead_time += completion_times[i] - order.release_time_minutes;
+            last_completion = std::max(last_completion, completion_times[i]);
+        }
+    }
+    if (first_release == std::numeric_limits<double>::max()) first_release = 0.0;   // Nothing released
+
+    double total_sim_time = last_completion - first_release;
+    if (total_sim_time <= 0) { total_sim_time = now > 0 ? now : 1.0; }
+
+    double agv_busy = 0.0;
+    for (size_t k = 0; k < fleet.size(); ++k) {
+        const Vehicle& v = fleet[k];
+        AgvStatistics stats;
+        stats.agv_id = (int)k + 1;
+        stats.operations = v.operations;
+        stats.busy_minutes = v.busy_minutes;
+        stats.congestion_delay_minutes = v.congestion_minutes;
+        stats.empty_km = v.empty_m / 1000.0;
+        stats.loaded_km = v.loaded_m / 1000.0;
+        stats.charging_minutes = v.charging_minutes;
+        if (config.fleet && (int)k < config.fleet->fleet_size()) {
+            stats.vehicle_type = config.fleet->get_type(config.fleet->type_of_slot((int)k)).name;
+        }
+        result.agv_stats.push_back(stats);
+        result.congestion_delay_minutes += v.congestion_minutes;
+        result.empty_km += stats.empty_km;
+        result.loaded_km += stats.loaded_km;
+        agv_busy += v.busy_minutes;
+        result.charging_minutes += v.charging_minutes;
+        result.min_soc = std::min(result.min_soc, v.min_soc);
+    }
+
+    if (planner) result.forced_route_entries = planner->get_forced_entries();
+    result.avg_lead_time = result.completed_orders > 0 ? total_lead_time / result.completed_orders : 0.0;
+    result.makespan_minutes = total_sim_time;
+    result.station_busy_minutes = station_busy;
+    result.setup_minutes = station_setup;
+    result.changeovers = changeovers;
+    result.lots = lots_started;
+    result.agv_busy_minutes = agv_busy;
+    result.station_utilization = station_busy / (slots.size() * total_sim_time);   // Slot-minutes used / available
+    result.throughput = result.completed_orders * 60.0 / total_sim_time;
+    result.agv_utilization = fleet.empty() ? 0.0 : agv_busy / (fleet.size() * total_sim_time);
+    result.events_processed = events;
+    result.dispatch_cycles = dispatch_cycles;
+    result.avg_cycle_solve_us = dispatch_cycles > 0 ? cycle_solve_seconds * 1e6 / dispatch_cycles : 0.0;
+    result.backhaul_trips = backhaul_trips;
+    result.wip_moves = wip_moves;
+    double span = now > first_release ? now - first_release : total_sim_time;   // Buffer levels are integrated to the last event
+    for (const auto& w : centers) {
+        WorkcenterStatistics stats;
+        stats.name = w.spec->name;
+        stats.machines = w.spec->machines;
+        stats.operations = w.operations;
+        stats.busy_minutes = w.busy;
+        stats.utilization = w.busy / (w.spec->machines * total_sim_time);
+        stats.avg_wait_minutes = w.operations > 0 ? w.wait / w.operations : 0.0;
+        stats.peak_queue = w.queued.peak;
+        stats.input_buffer = w.spec->input_buffer;
+        stats.output_buffer = w.spec->output_buffer;
+        stats.avg_input = (w.queued.area + w.queued.count * (now - w.queued.since)) / span;
+        stats.avg_output = (w.out.held.area + w.out.held.count * (now - w.out.held.since)) / span;
+        stats.peak_output = w.out.held.peak;
+        stats.blocked_minutes = w.out.blocked_minutes;
+        for (int i : w.out.blocked) stats.blocked_minutes += now - blocked_since[i];
+        result.workcenter_stats.push_back(stats);
+    }
+    result.station_blocked_minutes = station_out.blocked_minutes;
+    for (int i : station_out.blocked) result.station_blocked_minutes += now - blocked_since[i];
+    for (size_t i = 0; i < order_book.size(); ++i) {
+        if (order_route[i] >= 0 && !order_book[i].is_completed && !order_book[i].is_canceled) result.unfinished_jobs++;
+    }
+    if (result.unfinished_jobs > 0) {
+        log("Warning: " + std::to_string(result.unfinished_jobs) + " routed orders blocked at the end of the run (buffer deadlock)");
+    }
+    result.charger_wait_minutes = charger_wait;
+    result.charges = charges;
+    result.trace_hash = trace;
+
+    if (time_series) time_series->finish((int)std::ceil(now));
+
+    warehouse = nullptr;
+    orders = nullptr;
+    return result;
+}
+
+
+/**
+ * @brief Insert an event into the queue
+ */
+void DiscreteEventSimulator::schedule(double time, EventType type, int entity) {
+    Event ev;
+    ev.time = time;
+    ev.seq = next_seq++;
+    ev.type = type;
+    ev.entity = entity;
+    event_queue.push(ev);
+}
+
+
+/**
+ * @brief Fold an executed event into the trace hash
+ */
+void DiscreteEventSimulator::trace_event(const Event& ev) {
+    uint64_t time_bits;
+    std::memcpy(&time_bits, &ev.time, sizeof(time_bits));
+    trace = fnv_mix(trace, time_bits);
+    trace = fnv_mix(trace, (uint64_t)ev.type);
+    trace = fnv_mix(trace, (uint64_t)(int64_t)ev.entity);
+}
+
+
+void DiscreteEventSimulator::log(const std::string& message) {
+    if (logger) logger(now, message);
+}
+
+
+void DiscreteEventSimulator::diag(const std::string& message) {
+    if (config.diag_logging && logger) logger(now, "[Diag] " + message);
+}
+
+
+/**
+ * @brief Queue key of an order under the scheduling policy (smaller first)
+ * @param order_index Index into the order book
+ * @param process_minutes Nominal time of the operation it queues for (SPT key)
+ */
+double DiscreteEventSimulator::queue_key(int order_index, double process_minutes) const {
+    const Order& order = (*orders)[order_index];
+    switch (config.policy) {
+        case SchedulingPolicy::PRIORITY: return -(double)order.priority;
+        case SchedulingPolicy::SPT:      return process_minutes;
+        case SchedulingPolicy::EDD:
+        case SchedulingPolicy::SETUP:    // Look-ahead window in due-date order
+            return order.due_date_minutes >= 0 ? (double)order.due_date_minutes
+                                               : std::numeric_limits<double>::max();
+        case SchedulingPolicy::FIFO:
+        default:                         return 0.0;
+    }
+}
+
+
+/**
+ * @brief Put an order into the station queue, keyed by the scheduling policy
+ * @param order_index Index into the order book
+ */
+void DiscreteEventSimulator::enqueue_order(int order_index) {
+    QueuedOrder q;
+    q.seq = next_seq++;
+    q.order_index = order_index;
+    q.key = queue_key(order_index, operation_time(order_index));
+    station_queue.push(q);
+}
+
+
+/**
+ * @brief Orders assembled together with an order (1 unless it leads a lot)
+ */
+int DiscreteEventSimulator::lot_size(int order_index) const {
+    return std::max((int)lot_members[order_index].size(), 1);
+}
+
+
+/**
+ * @brief T_base for the order's lot, subassemblies included (30 per unit for unknown products)
+ */
+int DiscreteEventSimulator::base_time(int order_index) const {
+    const Product* product = order_products[order_index];
+    return (product ? product->total_assembly_minutes : 30) * lot_size(order_index);
+}
+
+
+/**
+ * @brief Nominal T_op = T_base + flat T_setup (the SPT key; one setup per lot)
+ */
+int DiscreteEventSimulator::operation_time(int order_index) const {
+    return base_time(order_index) + config.setup_time_minutes;
+}
+
+
+/**
+ * @brief Changeover before an order
+ * @param previous Product assembled last on the slot (nullptr for its first order)
+ * @param order_index Next order
+ * @return Setup minutes (the flat T_setup without a setup matrix)
+ */
+int DiscreteEventSimulator::setup_time(const std::string* previous, int order_index) const {
+    if (!config.setups) return config.setup_time_minutes;
+    static const std::string none;
+    return config.setups->setup_minutes(previous ? *previous : none, (*orders)[order_index].product_id);
+}
+
+
+/**
+ * @brief Assembly duration: nominal T_op scaled by the assembly-factor distribution
+ * @param order_index Order being assembled
+ * @param nominal T_base plus the setup this order pays on its slot
+ * @param activity 0 for assembly, k for the order's k-th routing step
+ *
+ * Each order has its own stream per activity, so its factors do not depend
+ * on the sequence chosen by the scheduling policy.
+ */
+double DiscreteEventSimulator::sample_assembly_time(int order_index, int nominal, uint32_t activity) const {
+    const Distribution& factor = config.process_times.assembly_factor;
+    if (factor.is_fixed()) return nominal * factor.sample(0.5);
+    RandomStream stream(config.seed, RandomStream::stream_id(STREAM_ORDER, activity, (uint64_t)(*orders)[order_index].order_id));
+    return nominal * std::max(0.0, factor.sample(stream.uniform()));
+}
+
+
+/**
+ * @brief Begin assembling the slot's order once all its components have arrived
+ */
+void DiscreteEventSimulator::start_assembly(int slot) {
+    StationSlot& s = slots[slot];
+    int order_index = s.order;
+    s.state = SLOT_ASSEMBLING;
+    int setup = setup_time(s.last_product, order_index);
+    int nominal = base_time(order_index) + setup;
+    double op = sample_assembly_time(order_index, nominal);
+    station_busy += op;
+    if (setup > 0) {
+        station_setup += nominal > 0 ? op * setup / nominal : 0.0;   // Setup share of the scaled time
+        changeovers++;
+    }
+    s.last_product = &(*orders)[order_index].product_id;
+    if (time_series) time_series->record_station_busy((int)now, (int)(now + op));
+    schedule(now + op, STATION_DONE, order_index);
+}
+
+
+/**
+ * @brief Start queued orders on the free station slots (lowest slot first)
+ *
+ * Mirrors AssemblyStation::process_orders: components are reserved
+ * atomically; on shortage the order is requeued and the station starts no
+ * order for retry_delay_minutes, and after max_request_retries the order
+ * is canceled.
+ */
+void DiscreteEventSimulator::station_try_start() {
+    while (!station_retry_wait && !station_queue.empty()) {
+        int slot = 0;
+        while (slot < (int)slots.size() && slots[slot].state != SLOT_IDLE) slot++;
+        if (slot == (int)slots.size()) return;
+
+        int i = pop_next_order(slot);
+        Order& order = (*orders)[i];
+        const Product* product = order_products[i];
+
+        int units = lot_size(i);
+        bool reserved = product && warehouse->reserve_components(product->leaf_requirements, units);
+        if (!reserved) {
+            int attempts = ++retry_counts[i];
+            if (attempts > config.max_request_retries) {
+                diag("request_components failed permanently for order ID " + std::to_string(order.order_id));
+                if (lot_members[i].empty()) lot_members[i].push_back(i);
+                for (int m : lot_members[i]) {
+                    Order& member = (*orders)[m];
+                    member.is_canceled = true;
+                    log("Order canceled: " + member.product_id + " (ID: " + std::to_string(member.order_id) + ")");
+                }
+                continue;
+            }
+            diag("request_components failed (attempt " + std::to_string(attempts) + ") requeue order " + order.product_id);
+            enqueue_order(i);
+            station_retry_wait = true;
+            schedule(now + config.retry_delay_minutes, STATION_RETRY, -1);
+            return;
+        }
+
+        retry_counts[i] = 0;
+        if (units > 1) lots_started++;
+        StationSlot& s = slots[slot];
+        s.order = i;
+        s.pending_units = 0;
+        for (const auto& comp : product->leaf_requirements) {
+            // One trip per BOM unit carries the whole lot, split when it exceeds the largest carrier's payload
+            TransportTask task = make_task(comp.component_id, false);
+            task.slot = slot;
+            int per_trip = config.fleet ? std::min(units, config.fleet->max_units(comp.component_id)) : units;
+            for (int q = 0; q < comp.quantity; ++q) {
+                for (int left = units; left > 0; left -= task.quantity) {
+                    task.quantity = std::min(per_trip, left);
+                    task.capable = capable_types(comp.component_id, task.quantity);
+                    transport_queue.push_back(task);
+                    s.pending_units++;
+                }
+            }
+        }
+        diag("wait_for_components start");
+        if (s.pending_units == 0) {
+            start_assembly(slot);
+        } else {
+            s.state = SLOT_WAITING_COMPONENTS;
+            waiting_slots++;
+        }
+        dispatch_transports();
+    }
+}
+
+
+/**
+ * @brief Take the next order for a free slot off the station queue
+ * @param slot Slot that will assemble it
+ * @return Order index
+ *
+ * Other policies take the queue head. SETUP looks at the first `lookahead`
+ * orders in due-date order and takes the one with the shortest changeover
+ * from the slot's last product (the earliest on ties), unless an order
+ * ahead of it could still finish by its due date if started now but not
+ * after it; the earliest such order goes first instead. Orders not taken
+ * keep their queue position.
+ */
+int DiscreteEventSimulator::pop_next_order(int slot) {
+    QueuedOrder head = station_queue.top();
+    station_queue.pop();
+    if (config.policy != SchedulingPolicy::SETUP) return head.order_index;
+
+    std::vector<QueuedOrder> window(1, head);
+    while ((int)window.size() < config.lookahead && !station_queue.empty()) {
+        window.push_back(station_queue.top());
+        station_queue.pop();
+    }
+
+    const std::string* previous = slots[slot].last_product;
+    size_t best = 0;
+    int best_setup = setup_time(previous, window[0].order_index);
+    for (size_t k = 1; k < window.size() && best_setup > 0; ++k) {
+        int setup = setup_time(previous, window[k].order_index);
+        if (setup < best_setup) { best = k; best_setup = setup; }
+    }
+
+    // Due-date guard: do not make an earlier order late that is on time now
+    int chosen = window[best].order_index;
+    double chosen_end = now + base_time(chosen) + best_setup;
+    for (size_t k = 0; k < best; ++k) {
+        int i = window[k].order_index;
+        int due = (*orders)[i].due_date_minutes;
+        if (due < 0) continue;
+        bool on_time_now = now + base_time(i) + setup_time(previous, i) <= due;
+        bool late_after = chosen_end + base_time(i) + setup_time(&(*orders)[chosen].product_id, i) > due;
+        if (on_time_now && late_after) { best = k; break; }
+    }
+
+    for (size_t k = 0; k < window.size(); ++k) {
+        if (k != best) station_queue.push(window[k]);
+    }
+    return window[best].order_index;
+}
+
+
+/**
+ * @brief Finish an assembly, free its slot and send the order on
+ *
+ * Orders without a routing are complete and their finished product returns
+ * to storage; routed orders leave for their first workcenter and may keep
+ * the slot blocked while the station's output buffer is full.
+ */
+void DiscreteEventSimulator::station_complete(int i) {
+    if (order_route[i] >= 0) {
+        depart(i, -1);
+    } else {
+        complete_order(i, -1);
+        for (auto& s : slots) {
+            if (s.state == SLOT_ASSEMBLING && s.order == i) { s.state = SLOT_IDLE; s.order = -1; break; }
+        }
+    }
+    dispatch_transports();
+    station_try_start();
+    release_outbound();
+}
+
+
+/**
+ * @brief Complete an order (or its lot) and queue the finished-product return
+ * @param i Order index
+ * @param from_center Workcenter of its last operation, -1 for the station
+ *
+ * With backhaul a product leaving the station waits there for the next
+ * component delivery; if no delivery is coming it is released as a
+ * separate task. Products leaving a workcenter are picked up there.
+ */
+void DiscreteEventSimulator::complete_order(int i, int from_center) {
+    if (lot_members[i].empty()) lot_members[i].push_back(i);
+    for (int m : lot_members[i]) {
+        Order& order = (*orders)[m];
+        order.is_completed = true;
+        order.completion_time_minutes = (int)std::lround(now);
+        completion_times[m] = now;
+        log("Order completed: " + order.product_id + " (ID: " + std::to_string(order.order_id) + ")");
+        if (time_series) time_series->record_completion((int)now);
+    }
+
+    // The lot's finished products travel back together
+    TransportTask finished = make_task((*orders)[i].product_id, true);
+    finished.quantity = (int)lot_members[i].size();
+    finished.capable = capable_types((*orders)[i].product_id, finished.quantity);
+    if (from_center >= 0) {
+        if (config.layout) finished.pickup_node = centers[from_center].node;
+        finished.buffered_job = i;
+        finished.source = from_center;
+        transport_queue.push_back(finished);
+    } else if (config.backhaul) {
+        outbound.push_back(finished);
+    } else {
+        transport_queue.push_back(finished);
+    }
+}
+
+
+/**
+ * @brief Resolve the product routings of the order book against the workcenters
+ *
+ * Orders of one product share a route. Eligible workcenters missing from
+ * the configuration are dropped, and so are steps left with none.
+ */
+void DiscreteEventSimulator::build_routes(const std::map<std::string, Product>& products) {
+    size_t n = orders->size();
+    centers.clear();
+    routes.clear();
+    order_route.assign(n, -1);
+    order_step.assign(n, 0);
+    order_center.assign(n, -1);
+    queued_since.assign(n, 0.0);
+    blocked_since.assign(n, -1.0);
+    awaiting_space.assign(n, 0);
+    Occupancy empty_level;
+    empty_level.count = 0;
+    empty_level.peak = 0;
+    empty_level.area = 0.0;
+    empty_level.since = 0.0;
+    station_out = OutputBuffer();
+    station_out.capacity = config.station_output_buffer;
+    station_out.held = empty_level;
+    station_out.blocked_minutes = 0.0;
+    wip_moves = 0;
+    if (!config.workcenters) return;
+
+    std::map<std::string, int> center_index;
+    for (const Workcenter& wc : *config.workcenters) {
+        WorkcenterState w;
+        w.spec = &wc;
+        w.node = -1;
+        if (config.layout) {
+            w.node = config.layout->find_node(wc.node.empty() ? wc.name : wc.node);
+            if (w.node < 0) w.node = config.layout->station_node();
+        }
+        w.machines_free = std::max(wc.machines, 1);
+        w.inbound = 0;
+        w.queued = empty_level;
+        w.out.capacity = wc.output_buffer;
+        w.out.held = empty_level;
+        w.out.blocked_minutes = 0.0;
+        w.busy = 0.0;
+        w.wait = 0.0;
+        w.operations = 0;
+        center_index[wc.name] = (int)centers.size();
+        centers.push_back(w);
+    }
+
+    std::map<const Product*, int> route_of;
+    for (const auto& entry : products) {
+        const Product& product = entry.second;
+        std::vector<RoutedOperation> route;
+        for (const Operation& op : product.routing) {
+            RoutedOperation step;
+            step.op = &op;
+            for (const std::string& name : op.workcenters) {
+                auto it = center_index.find(name);
+                if (it != center_index.end()) step.centers.push_back(it->second);
+            }
+            if (!step.centers.empty()) route.push_back(step);
+        }
+        if (route.empty()) continue;
+        route_of[&product] = (int)routes.size();
+        routes.push_back(route);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        auto it = route_of.find(order_products[i]);
+        if (it != route_of.end()) order_route[i] = it->second;
+    }
+}
+
+
+/**
+ * @brief Whether a workcenter can take one more job (queued plus inbound below its input buffer)
+ */
+bool DiscreteEventSimulator::has_input_space(int center) const {
+    const WorkcenterState& w = centers[center];
+    int capacity = w.spec->input_buffer;
+    return capacity < 0 || (int)w.queue.size() + w.inbound < capacity;
+}
+
+
+/**
+ * @brief Move a finished job off its machine (or station slot) and send it on
+ * @param i Order index (lot lead)
+ * @param from_center Workcenter it finished at, -1 for the station
+ *
+ * Blocking after service: the job takes a place in the output buffer if
+ * one is free and releases its machine; otherwise it keeps the machine
+ * until it is picked up or an output place frees. A job whose next
+ * workcenter has no input space waits without an AGV being sent.
+ */
+void DiscreteEventSimulator::depart(int i, int from_center) {
+    order_center[i] = from_center;
+    OutputBuffer& out = output_of(from_center);
+    bool holding = !out.has_space();
+    if (holding) {
+        out.blocked.push_back(i);
+        blocked_since[i] = now;
+        if (from_center < 0) {
+            for (auto& s : slots) {
+                if (s.state == SLOT_ASSEMBLING && s.order == i) { s.state = SLOT_BLOCKED; break; }
+            }
+        }
+        diag("order ID " + std::to_string((*orders)[i].order_id) + " blocks its " +
+             (from_center >= 0 ? "machine at " + centers[from_center].spec->name : std::string("station slot")));
+    } else {
+        out.held.change(now, 1);
+    }
+
+    if (order_step[i] >= (int)routes[order_route[i]].size()) complete_order(i, from_center);
+    else if (!route_next(i, from_center)) wait_for_space(i);
+    if (!holding) release_holder(i, from_center);
+}
+
+
+/**
+ * @brief Send an order to the workcenter of its next routing step
+ * @param i Order index (lot lead)
+ * @param from_center Workcenter it leaves, -1 for the station
+ * @return false if no eligible workcenter has input space
+ *
+ * Among the eligible workcenters with input space the one with the least
+ * work per machine (queued, inbound and in process) is chosen, the first
+ * on ties, so a full workcenter redirects the job to an alternative. The
+ * job stays put if that is where it already is; otherwise an AGV moves it
+ * and the input place is reserved until it arrives.
+ */
+bool DiscreteEventSimulator::route_next(int i, int from_center) {
+    const RoutedOperation& step = routes[order_route[i]][order_step[i]];
+    int best = -1;
+    double best_load = std::numeric_limits<double>::max();
+    for (int c : step.centers) {
+        if (!has_input_space(c)) continue;
+        const WorkcenterState& w = centers[c];
+        int machines = std::max(w.spec->machines, 1);
+        double load = (double)(w.queue.size() + w.inbound + machines - w.machines_free) / machines;
+        if (load < best_load) { best = c; best_load = load; }
+    }
+    if (best < 0) return false;
+    if (best == from_center) {
+        picked_up(i, from_center);
+        workcenter_arrive(best, i);
+        return true;
+    }
+
+    const std::string& product_id = (*orders)[i].product_id;
+    TransportTask move = make_task(product_id, false);
+    move.job = i;
+    move.workcenter = best;
+    move.quantity = lot_size(i);
+    move.capable = capable_types(product_id, move.quantity);
+    move.buffered_job = i;
+    move.source = from_center;
+    if (config.layout) {
+        move.pickup_node = from_center >= 0 ? centers[from_center].node : config.layout->station_node();
+        move.dropoff_node = centers[best].node;
+    }
+    centers[best].inbound++;
+    wip_moves++;
+    transport_queue.push_back(move);
+    diag("route " + product_id + " (ID: " + std::to_string((*orders)[i].order_id) + ") to " + centers[best].spec->name);
+    return true;
+}
+
+
+/**
+ * @brief Park a finished job until one of its next eligible workcenters has input space
+ */
+void DiscreteEventSimulator::wait_for_space(int i) {
+    awaiting_space[i] = 1;
+    for (int c : routes[order_route[i]][order_step[i]].centers) centers[c].space_waiters.push_back(i);
+    diag("order ID " + std::to_string((*orders)[i].order_id) + " waits for input space downstream");
+}
+
+
+/**
+ * @brief Route jobs waiting for input space here, oldest first, while space lasts
+ */
+void DiscreteEventSimulator::admit_waiting(int center) {
+    WorkcenterState& w = centers[center];
+    while (!w.space_waiters.empty() && has_input_space(center)) {
+        int i = w.space_waiters.front();
+        w.space_waiters.pop_front();
+        if (!awaiting_space[i]) continue;        // Routed through another workcenter meanwhile
+        awaiting_space[i] = 0;
+        if (!route_next(i, order_center[i])) wait_for_space(i);
+    }
+}
+
+
+/**
+ * @brief A job left its source: free its output place (or the machine it blocked)
+ *
+ * A freed output place goes to the job that has blocked a machine longest,
+ * which releases that machine.
+ */
+void DiscreteEventSimulator::picked_up(int i, int from_center) {
+    OutputBuffer& out = output_of(from_center);
+    if (blocked_since[i] >= 0.0) {
+        out.blocked.erase(std::find(out.blocked.begin(), out.blocked.end(), i));
+        out.blocked_minutes += now - blocked_since[i];
+        blocked_since[i] = -1.0;
+        release_holder(i, from_center);
+        return;
+    }
+    out.held.change(now, -1);
+    if (!out.blocked.empty() && out.has_space()) {
+        int j = out.blocked.front();
+        out.blocked.pop_front();
+        out.blocked_minutes += now - blocked_since[j];
+        blocked_since[j] = -1.0;
+        out.held.change(now, 1);
+        release_holder(j, from_center);
+    }
+}
+
+
+/**
+ * @brief Free the machine or station slot a finished job occupied and start the next job on it
+ */
+void DiscreteEventSimulator::release_holder(int i, int from_center) {
+    if (from_center >= 0) {
+        centers[from_center].machines_free++;
+        workcenter_try_start(from_center);
+        return;
+    }
+    for (auto& s : slots) {
+        if ((s.state == SLOT_ASSEMBLING || s.state == SLOT_BLOCKED) && s.order == i) {
+            s.state = SLOT_IDLE;
+            s.order = -1;
+            break;
+        }
+    }
+    station_try_start();
+}
+
+
+/**
+ * @brief Queue an arrived job at a workcenter, keyed by the scheduling policy
+ */
+void DiscreteEventSimulator::workcenter_arrive(int center, int i) {
+    WorkcenterState& w = centers[center];
+    const Operation& op = *routes[order_route[i]][order_step[i]].op;
+    QueuedOrder q;
+    q.seq = next_seq++;
+    q.order_index = i;
+    q.key = queue_key(i, (double)op.process_minutes * lot_size(i));
+    w.queue.push(q);
+    w.queued.change(now, 1);
+    queued_since[i] = now;
+    workcenter_try_start(center);
+}
+
+
+/**
+ * @brief Start queued jobs on the workcenter's free machines
+ *
+ * A lot is processed as one job: per-unit time times the lot size, scaled
+ * by the order's assembly-factor stream for this step. Each start frees
+ * an input place for jobs waiting upstream.
+ */
+void DiscreteEventSimulator::workcenter_try_start(int center) {
+    WorkcenterState& w = centers[center];
+    while (w.machines_free > 0 && !w.queue.empty()) {
+        int i = w.queue.top().order_index;
+        w.queue.pop();
+        w.queued.change(now, -1);
+        w.machines_free--;
+        w.wait += now - queued_since[i];
+        w.operations++;
+        const Operation& op = *routes[order_route[i]][order_step[i]].op;
+        double minutes = sample_assembly_time(i, op.process_minutes * lot_size(i), (uint32_t)order_step[i] + 1);
+        w.busy += minutes;
+        order_center[i] = center;
+        diag("operation " + op.name + " start for order ID " + std::to_string((*orders)[i].order_id) +
+             " at " + w.spec->name);
+        schedule(now + minutes, OPERATION_DONE, i);
+    }
+    admit_waiting(center);
+}
+
+
+/**
+ * @brief Finish a routing step and send the job on (or complete it)
+ */
+void DiscreteEventSimulator::operation_complete(int i) {
+    order_step[i]++;
+    depart(i, order_center[i]);
+    dispatch_transports();
+}
+
+
+/**
+ * @brief Queue a closed lot at the station as its first order
+ *
+ * The lot is reserved, moved and assembled as one job with one setup;
+ * station_complete() then completes every order in it.
+ */
+void DiscreteEventSimulator::close_lot(const Lot& lot) {
+    int lead = lot.members.front();
+    if (lot.members.size() > 1) {
+        lot_members[lead] = lot.members;
+        diag("lot of " + std::to_string(lot.members.size()) + " orders closed: " + lot.product_id);
+    }
+    enqueue_order(lead);
+    station_try_start();
+}
+
+
+/**
+ * @brief Build a transport task with its pickup and drop-off nodes
+ *
+ * Components go from their storage node to the station, finished products
+ * from the station to their storage node (the warehouse unless mapped).
+ */
+DiscreteEventSimulator::TransportTask DiscreteEventSimulator::make_task(const std::string& item_id,
+                                                                        bool is_finished_product) const {
+    TransportTask task;
+    task.item_id = &item_id;
+    task.is_finished_product = is_finished_product;
+    task.pickup_node = -1;
+    task.dropoff_node = -1;
+    task.slot = -1;
+    task.quantity = 1;
+    task.job = -1;
+    task.workcenter = -1;
+    task.buffered_job = -1;
+    task.source = -1;
+    task.capable = capable_types(item_id, 1);
+    if (config.layout) {
+        int storage = config.layout->storage_node(item_id);
+        int station = config.layout->station_node();
+        task.pickup_node = is_finished_product ? station : storage;
+        task.dropoff_node = is_finished_product ? storage : station;
+    }
+    return task;
+}
+
+
+/**
+ * @brief Vehicle types that may carry `quantity` units of an item in one trip (all types without a fleet profile)
+ */
+uint64_t DiscreteEventSimulator::capable_types(const std::string& item_id, int quantity) const {
+    return config.fleet ? config.fleet->capability_mask(item_id, quantity) : FleetIndex::ANY_TYPE;
+}
+
+
+/**
+ * @brief Assign queued transport tasks to idle AGVs
+ *
+ * With a layout or fleet profile, each task goes to the capable idle AGV
+ * with the earliest arrival at its pickup node (a task no idle AGV may carry
+ * waits, later ones still go out), or waits for the next dispatch cycle
+ * when cycles are enabled. AGVs opportunity-charging above the threshold are unplugged when
+ * tasks outnumber idle AGVs. Without one, component units go round-robin over the fleet and
+ * finished products to the first idle AGV, as in AssemblyStation.
+ */
+void DiscreteEventSimulator::dispatch_transports() {
+    while ((int)transport_queue.size() > idle_vehicles && unplug_for_work()) {}
+
+    if (idle_index && config.dispatch_cycle_minutes > 0.0) {
+        if (!cycle_scheduled && !transport_queue.empty() && idle_vehicles > 0) {
+            double interval = config.dispatch_cycle_minutes;
+            schedule(std::max(now, std::ceil(now / interval) * interval), DISPATCH_CYCLE, -1);
+            cycle_scheduled = true;
+        }
+        return;
+    }
+
+    if (idle_index) {
+        for (auto it = transport_queue.begin(); it != transport_queue.end() && idle_vehicles > 0;) {
+            int nearest = idle_index->claim_nearest(it->pickup_node, it->capable);
+            if (nearest < 0) { ++it; continue; }
+            TransportTask task = *it;
+            it = transport_queue.erase(it);
+            assign_vehicle(nearest, task);
+        }
+        return;
+    }
+
+    while (!transport_queue.empty() && idle_vehicles > 0) {
+        TransportTask task = transport_queue.front();
+        transport_queue.pop_front();
+
+        size_t n = fleet.size();
+        size_t chosen = 0;
+        if (task.is_finished_product || task.job >= 0) {
+            while (fleet[chosen].state != AGVState::IDLE) ++chosen;
+        } else {
+            for (size_t k = 0; k < n; ++k) {
+                size_t idx = (rr_index + k) % n;
+                if (fleet[idx].state == AGVState::IDLE) { chosen = idx; break; }
+            }
+            rr_index = (chosen + 1) % n;
+        }
+        assign_vehicle((int)chosen, task);
+    }
+}
+
+
+/**
+ * @brief Jointly assign the oldest pending tasks to the idle AGVs
+ *
+ * Up to one task per idle AGV is taken in queue order (so no task starves),
+ * skipping tasks that no idle AGV's type may carry; they keep their place
+ * in the queue. The task/AGV pairing minimizing total empty travel time is
+ * solved with the Hungarian algorithm. Pairs the fleet profile forbids
+ * cost UNREACHABLE and are not assigned. Remaining tasks wait for the
+ * cycle after the next AGV becomes idle.
+ */
+void DiscreteEventSimulator::run_dispatch_cycle() {
+    cycle_scheduled = false;
+    if (transport_queue.empty() || idle_vehicles == 0) return;
+
+    cycle_agvs.clear();
+    uint64_t idle_types = 0;
+    for (size_t k = 0; k < fleet.size(); ++k) {
+        if (fleet[k].state != AGVState::IDLE) continue;
+        cycle_agvs.push_back((int)k);
+        idle_types |= (uint64_t)1 << (config.fleet ? config.fleet->type_of_slot((int)k) : 0);
+    }
+    int cols = (int)cycle_agvs.size();
+    cycle_tasks.clear();
+    for (size_t q = 0; q < transport_queue.size() && (int)cycle_tasks.size() < cols; ++q) {
+        if (transport_queue[q].capable & idle_types) cycle_tasks.push_back(q);
+    }
+    int rows = (int)cycle_tasks.size();
+    if (rows == 0) return;
+
+    const double UNREACHABLE = 1e9;
+    cycle_cost.resize((size_t)rows * cols);
+    for (int r = 0; r < rows; ++r) {
+        const TransportTask& task = transport_queue[cycle_tasks[r]];
+        for (int c = 0; c < cols; ++c) {
+            const Vehicle& v = fleet[cycle_agvs[c]];
+            bool capable = config.fleet == nullptr ||
+                           ((task.capable >> config.fleet->type_of_slot(cycle_agvs[c])) & 1);
+            double t = capable ? config.layout->travel_time(v.location, task.pickup_node) / v.speed : UNREACHABLE;
+            cycle_cost[(size_t)r * cols + c] = t < UNREACHABLE ? t : UNREACHABLE;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<int>& pairing = cycle_solver.solve(cycle_cost, rows, cols);
+    cycle_solve_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    dispatch_cycles++;
+    diag("dispatch cycle: " + std::to_string(rows) + " tasks, " + std::to_string(cols) + " idle AGVs");
+
+    // Assign, then close the gaps up to the last row so the queue keeps its order
+    size_t end = cycle_tasks[rows - 1] + 1;
+    size_t kept = 0;
+    int r = 0;
+    for (size_t q = 0; q < end; ++q) {
+        bool row = r < rows && cycle_tasks[r] == q;
+        if (row && cycle_cost[(size_t)r * cols + pairing[r]] < UNREACHABLE) {
+            int agv = cycle_agvs[pairing[r]];
+            idle_index->remove_idle(agv);
+            assign_vehicle(agv, transport_queue[q]);
+        } else {
+            if (kept != q) transport_queue[kept] = transport_queue[q];
+            kept++;
+        }
+        if (row) r++;
+    }
+    transport_queue.erase(transport_queue.begin() + kept, transport_queue.begin() + end);
+}
+
+
+/**
+ * @brief Hand a task to an idle AGV and start its first leg
+ */
+void DiscreteEventSimulator::assign_vehicle(int agv, const TransportTask& task) {
+    Vehicle& v = fleet[agv];
+    v.task = task;
+    v.task_start = now;
+    idle_vehicles--;
+    if (task.is_finished_product) {
+        diag("assign finished product " + *task.item_id + " to AGV" + std::to_string(agv + 1));
+    } else if (task.job >= 0) {
+        diag("assign work in process " + *task.item_id + " to AGV" + std::to_string(agv + 1));
+    } else {
+        diag("assign_task " + *task.item_id + " to AGV" + std::to_string(agv + 1));
+    }
+    start_leg(agv, AGVState::TO_WAREHOUSE);
+}
+
+
+/**
+ * @brief Turn an AGV that just dropped components into a finished-product return
+ * @return false if no waiting product may ride on the AGV's vehicle type
+ *
+ * The AGV picks the product at the station and takes it to its storage node
+ * (RETURNING) instead of leaving empty, so the product needs no empty trip.
+ * Products its type may not carry stay queued for release_outbound.
+ */
+bool DiscreteEventSimulator::start_backhaul(int agv) {
+    int type = config.fleet ? config.fleet->type_of_slot(agv) : 0;
+    auto it = outbound.begin();
+    while (it != outbound.end() && !((it->capable >> type) & 1)) ++it;
+    if (it == outbound.end()) return false;
+
+    Vehicle& v = fleet[agv];
+    v.task = *it;
+    outbound.erase(it);
+    v.task_start = now;
+    v.backhaul = true;
+    backhaul_trips++;
+    diag("backhaul finished product " + *v.task.item_id + " on AGV" + std::to_string(agv + 1));
+    start_leg(agv, AGVState::PICKING);
+    return true;
+}
+
+
+/**
+ * @brief Hand waiting finished products to the dispatcher once no component delivery is expected
+ */
+void DiscreteEventSimulator::release_outbound() {
+    if (outbound.empty() || waiting_slots > 0) return;
+    transport_queue.insert(transport_queue.end(), outbound.begin(), outbound.end());
+    outbound.clear();
+    dispatch_transports();
+}
+
+
+/**
+ * @brief Free-flow layout travel time of a leg (current node -> pickup, pickup -> drop-off) at the AGV's speed
+ */
+double DiscreteEventSimulator::travel_minutes(int agv, AGVState leg) const {
+    const Vehicle& v = fleet[agv];
+    if (leg == AGVState::TO_WAREHOUSE) return config.layout->travel_time(v.location, v.task.pickup_node) / v.speed;
+    return config.layout->travel_time(v.task.pickup_node, v.task.dropoff_node) / v.speed;
+}
+
+
+/**
+ * @brief Plan a leg through traffic and return the waiting it adds to free flow
+ */
+double DiscreteEventSimulator::congestion_delay(int agv, AGVState leg) {
+    const Vehicle& v = fleet[agv];
+    int from = leg == AGVState::TO_WAREHOUSE ? v.location : v.task.pickup_node;
+    int to = leg == AGVState::TO_WAREHOUSE ? v.task.pickup_node : v.task.dropoff_node;
+    PlannedRoute route = planner->plan(from, to, now);
+    double delay = std::max(0.0, route.delay());
+    if (delay > 0.0) {
+        diag("AGV" + std::to_string(agv + 1) + " congestion delay " + std::to_string(delay) + " min");
+    }
+    return delay;
+}
+
+
+/**
+ * @brief Enter a travel/handling state and schedule its end
+ *
+ * With a layout, travel legs take the matrix time scaled by
+ * sample / mean of the leg's distribution, plus the waiting planned by the
+ * route planner when congestion routing is on.
+ */
+void DiscreteEventSimulator::start_leg(int agv, AGVState leg) {
+    const Distribution* dist = nullptr;
+    int stream = 0;
+    switch (leg) {
+        case AGVState::TO_WAREHOUSE: dist = &config.process_times.travel_warehouse; stream = 0; break;
+        case AGVState::PICKING:      dist = &config.process_times.picking;          stream = 1; break;
+        case AGVState::TO_STATION:
+        case AGVState::RETURNING:    dist = &config.process_times.travel_station;   stream = 2; break;
+        case AGVState::DROPPING:     dist = &config.process_times.dropping;         stream = 3; break;
+        default: break;
+    }
+    double duration = 0.0;
+    bool travel = leg == AGVState::TO_WAREHOUSE || leg == AGVState::TO_STATION || leg == AGVState::RETURNING;
+    if (travel && config.layout) {
+        duration = travel_minutes(agv, leg);
+        Vehicle& v = fleet[agv];
+        if (leg == AGVState::TO_WAREHOUSE) v.empty_m += config.layout->distance(v.location, v.task.pickup_node);
+        else v.loaded_m += config.layout->distance(v.task.pickup_node, v.task.dropoff_node);
+        if (!dist->is_fixed() && dist->mean() > 0.0) {
+            duration *= std::max(0.0, dist->sample(fleet[agv].leg_streams[stream].uniform())) / dist->mean();
+        }
+        if (planner) {
+            double delay = congestion_delay(agv, leg);
+            fleet[agv].congestion_minutes += delay;
+            duration += delay;
+        }
+    } else if (dist) {
+        duration = dist->is_fixed() ? dist->sample(0.5)
+                                    : std::max(0.0, dist->sample(fleet[agv].leg_streams[stream].uniform()));
+        if (travel) duration /= fleet[agv].speed;
+    }
+    fleet[agv].state = leg;
+    if (config.battery.enabled) drain(fleet[agv], leg, duration);
+    schedule_leg(agv, now + duration);
+}
+
+
+/**
+ * @brief Schedule the end of an AGV's current leg, superseding any earlier one
+ */
+void DiscreteEventSimulator::schedule_leg(int agv, double time) {
+    fleet[agv].leg_event = next_seq;
+    schedule(time, AGV_LEG_DONE, agv);
+}
+
+
+/**
+ * @brief Discharge for a leg: empty or loaded driving, or handling
+ */
+void DiscreteEventSimulator::drain(Vehicle& v, AGVState leg, double minutes) {
+    const BatteryModel& b = config.battery;
+    double rate = leg == AGVState::TO_WAREHOUSE ? b.drain_empty
+                : (leg == AGVState::TO_STATION || leg == AGVState::RETURNING) ? b.drain_loaded
+                : b.drain_handling;
+    v.soc = std::max(0.0, v.soc - rate * minutes);
+    v.min_soc = std::min(v.min_soc, v.soc);
+}
+
+
+/**
+ * @brief Advance the AGV state machine after a leg (same sequence as AGV::run)
+ */
+void DiscreteEventSimulator::on_leg_done(int agv) {
+    Vehicle& v = fleet[agv];
+    switch (v.state) {
+        case AGVState::TO_WAREHOUSE: start_leg(agv, AGVState::PICKING); return;
+        case AGVState::PICKING:
+            start_leg(agv, v.backhaul ? AGVState::RETURNING : AGVState::TO_STATION);
+            if (v.task.buffered_job >= 0) {
+                picked_up(v.task.buffered_job, v.task.source);
+                dispatch_transports();
+            }
+            return;
+        case AGVState::TO_STATION:
+        case AGVState::RETURNING:    start_leg(agv, AGVState::DROPPING); return;
+        default: break;
+    }
+
+    // DROPPING finished: task complete
+    v.busy_minutes += now - v.task_start;
+    v.operations++;
+    v.location = v.task.dropoff_node;
+    v.backhaul = false;
+    TransportTask done = v.task;
+    bool component = !done.is_finished_product && done.job < 0;
+    if (config.battery.enabled && v.soc < config.battery.threshold) {
+        send_to_charger(agv, false);   // Charging comes first: no backhaul below the threshold
+    } else if (!component || !start_backhaul(agv)) {
+        v.state = AGVState::IDLE;
+        idle_vehicles++;
+        if (idle_index) idle_index->add_idle(agv, v.location);
+    }
+
+    if (done.job >= 0) {
+        diag("work in process delivered " + *done.item_id + " to " + centers[done.workcenter].spec->name);
+        centers[done.workcenter].inbound--;
+        workcenter_arrive(done.workcenter, done.job);
+    } else if (component) {
+        diag("delivered " + *done.item_id + " x" + std::to_string(done.quantity));
+        StationSlot& s = slots[done.slot];
+        if (--s.pending_units == 0 && s.state == SLOT_WAITING_COMPONENTS) {
+            diag("wait_for_components done");
+            waiting_slots--;
+            start_assembly(done.slot);
+        }
+    } else {
+        diag("finished product delivered " + *done.item_id);
+        warehouse->add_finished_product(*done.item_id, done.quantity);
+    }
+    release_outbound();
+    dispatch_transports();
+
+    // Opportunity charging: top up while nothing is waiting and a charger is free
+    if (config.battery.opportunity && v.state == AGVState::IDLE && v.soc < config.battery.target &&
+        transport_queue.empty() && chargers_free > opportunity_driving) {
+        idle_vehicles--;
+        if (idle_index) idle_index->remove_idle(agv);
+        send_to_charger(agv, true);
+    }
+}
+
+
+/**
+ * @brief Head for the chargers (state CHARGING until charged or unplugged)
+ * @param opportunity true for an idle top-up, false when below the threshold
+ */
+void DiscreteEventSimulator::send_to_charger(int agv, bool opportunity) {
+    Vehicle& v = fleet[agv];
+    v.state = AGVState::CHARGING;
+    v.charge_phase = CHARGE_DRIVING;
+    v.opportunity_charge = opportunity;
+    v.charge_begin = now;
+    if (opportunity) opportunity_driving++;
+    double travel = 0.0;
+    if (config.layout) {
+        travel = config.layout->travel_time(v.location, charger_node) / v.speed;
+        v.empty_m += config.layout->distance(v.location, charger_node);
+    }
+    drain(v, AGVState::TO_WAREHOUSE, travel);
+    diag("AGV" + std::to_string(agv + 1) + " to charger at " + std::to_string((int)v.soc) + "%");
+    schedule_leg(agv, now + travel);
+}
+
+
+/**
+ * @brief Occupy a free charger until the target charge is reached
+ */
+void DiscreteEventSimulator::plug_in(int agv) {
+    Vehicle& v = fleet[agv];
+    chargers_free--;
+    charges++;
+    v.charge_phase = CHARGE_PLUGGED;
+    v.plug_time = now;
+    schedule_leg(agv, now + std::max(0.0, config.battery.target - v.soc) / config.battery.charge_rate);
+}
+
+
+/**
+ * @brief Give free chargers to queued AGVs in arrival order
+ */
+void DiscreteEventSimulator::plug_waiting() {
+    while (chargers_free > 0 && !charger_queue.empty()) {
+        int agv = charger_queue.front();
+        charger_queue.pop_front();
+        charger_wait += now - fleet[agv].plug_time;
+        plug_in(agv);
+    }
+}
+
+
+/**
+ * @brief Return a charged (or unplugged) AGV to service at the charger node
+ */
+void DiscreteEventSimulator::finish_charge(int agv) {
+    Vehicle& v = fleet[agv];
+    v.charging_minutes += now - v.charge_begin;
+    v.opportunity_charge = false;
+    v.state = AGVState::IDLE;
+    idle_vehicles++;
+    if (idle_index) idle_index->add_idle(agv, v.location);
+}
+
+
+/**
+ * @brief Unplug the fullest opportunity-charging AGV that is above the threshold
+ * @return false if none qualifies
+ */
+bool DiscreteEventSimulator::unplug_for_work() {
+    if (!config.battery.opportunity) return false;
+    int best = -1;
+    double best_soc = config.battery.threshold;
+    for (size_t k = 0; k < fleet.size(); ++k) {
+        const Vehicle& v = fleet[k];
+        if (v.state != AGVState::CHARGING || v.charge_phase != CHARGE_PLUGGED || !v.opportunity_charge) continue;
+        double soc = v.soc + (now - v.plug_time) * config.battery.charge_rate;
+        if (soc >= best_soc) { best_soc = soc; best = (int)k; }
+    }
+    if (best < 0) return false;
+
+    Vehicle& v = fleet[best];
+    v.soc = std::min(best_soc, config.battery.target);
+    v.leg_event = 0;                     // Drop the scheduled end of charge
+    chargers_free++;
+    diag("AGV" + std::to_string(best + 1) + " unplugged for work at " + std::to_string((int)v.soc) + "%");
+    finish_charge(best);
+    plug_waiting();
+    return true;
+}
+
+
+/**
+ * @brief Advance a charging AGV: arrival at the chargers or end of charge
+ */
+void DiscreteEventSimulator::on_charge_event(int agv) {
+    Vehicle& v = fleet[agv];
+    if (v.charge_phase == CHARGE_DRIVING) {
+        if (v.opportunity_charge) opportunity_driving--;
+        if (config.layout) v.location = charger_node;
+        if (chargers_free > 0) {
+            plug_in(agv);
+        } else if (v.opportunity_charge) {
+            finish_charge(agv);          // Charger taken meanwhile: wait for work instead
+            dispatch_transports();
+        } else {
+            v.charge_phase = CHARGE_QUEUED;
+            v.plug_time = now;
+            charger_queue.push_back(agv);
+        }
+        return;
+    }
+
+    // CHARGE_PLUGGED: target reached
+    v.soc = std::max(v.soc, config.battery.target);
+    chargers_free++;
+    diag("AGV" + std::to_string(agv + 1) + " charged");
+    finish_charge(agv);
+    plug_waiting();
+    dispatch_transports();
+}
+/*************************************************************************************/
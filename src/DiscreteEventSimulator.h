@@ -0,0 +1,444 @@
+/**
+ * @file DiscreteEventSimulator.h
+ * @brief Single-threaded, deterministic discrete-event model of the assembly cell
+ */
+
+#ifndef DISCRETE_EVENT_SIMULATOR_H
+#define DISCRETE_EVENT_SIMULATOR_H
+
+/******************************Project Headers*****************************************/
+#include "Order.h"
+#include "Product.h"
+#include "Warehouse.h"
+#include "AGV.h"
+#include "ControlCenter.h"
+#include "KpiTimeSeries.h"
+#include "Distribution.h"
+#include "RandomStream.h"
+#include "Layout.h"
+#include "RoutePlanner.h"
+#include "FleetIndex.h"
+#include "FleetProfile.h"
+#include "AssignmentSolver.h"
+#include "Battery.h"
+#include "SetupMatrix.h"
+#include "LotBatcher.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <queue>
+#include <cstdint>
+#include <functional>
+#include <memory>
+/*************************************************************************************/
+
+/****************************Simulation Configuration*********************************/
+/**
+ * @struct SimulationConfig
+ * @brief Parameters of a deterministic run (defaults match AGV and AssemblyStation)
+ */
+struct SimulationConfig {
+    int num_agvs;
+    SchedulingPolicy policy;
+    uint64_t seed;                       // Root of every random stream in the run
+
+    // AGV leg durations and assembly-time variation (fixed nominal times by default)
+    ProcessTimeModel process_times;
+
+    // Shop-floor layout; when set, travel legs come from its travel-time matrix
+    // and the travel distributions only add variation around it (mean-1 factor)
+    const Layout* layout;
+    bool congestion_routing;             // Plan layout moves against a space-time reservation table
+    double dispatch_cycle_minutes;       // > 0: batch transport tasks and assign them jointly (layout only)
+    bool backhaul;                       // Component AGVs carry finished products back from the station
+    BatteryModel battery;                // State of charge and chargers (disabled by default)
+    const FleetProfile* fleet;           // Vehicle types per slot; num_agvs should match its fleet size
+
+    // Station
+    int station_slots;                   // Orders assembled in parallel (fixtures or operators)
+    int setup_time_minutes;              // T_setup
+    const SetupMatrix* setups;           // Sequence-dependent setups per slot (nullptr: flat T_setup)
+    int lookahead;                       // SETUP policy: queued orders considered per pick
+    int lot_window_minutes;              // > 0: merge same-product orders released within it into lots
+    int lot_max_size;                    // Orders per lot (0: no cap)
+    int max_request_retries;             // Shortage retries before an order is canceled
+    int retry_delay_minutes;             // Station wait between shortage retries
+
+    // Workcenters for the product routings after assembly (nullptr: assembly only)
+    const std::vector<Workcenter>* workcenters;
+    int station_output_buffer;           // Routed jobs waiting for pickup at the station (-1: unlimited)
+
+    bool diag_logging;                   // Emit per-task [Diag] events to the logger
+
+    SimulationConfig()
+        : num_agvs(20), policy(SchedulingPolicy::FIFO), seed(1), layout(nullptr), congestion_routing(false),
+          dispatch_cycle_minutes(0.0), backhaul(false), fleet(nullptr),
+          station_slots(1), setup_time_minutes(5), setups(nullptr), lookahead(8), lot_window_minutes(0), lot_max_size(0), max_request_retries(100), retry_delay_minutes(1),
+          workcenters(nullptr), station_output_buffer(-1), diag_logging(false) {}
+};
+
+/**
+ * @struct WorkcenterStatistics
+ * @brief Per-workcenter results of a run with routings
+ */
+struct WorkcenterStatistics {
+    std::string name;
+    int machines;
+    int operations;                      // Operations started (a lot counts once)
+    double busy_minutes;                 // Machine-minutes processing
+    double utilization;                  // Machine-minutes used / available over the makespan
+    double avg_wait_minutes;             // Queue wait per operation
+    int peak_queue;                      // Most jobs waiting at once
+    int input_buffer;                    // Capacities (-1: unlimited)
+    int output_buffer;
+    double avg_input;                    // Time-average jobs in the input buffer (queue)
+    double avg_output;                   // Time-average finished jobs waiting for pickup
+    int peak_output;
+    double blocked_minutes;              // Machine-minutes held by finished jobs (output buffer full)
+
+    WorkcenterStatistics()
+        : machines(0), operations(0), busy_minutes(0.0), utilization(0.0), avg_wait_minutes(0.0), peak_queue(0),
+          input_buffer(-1), output_buffer(-1), avg_input(0.0), avg_output(0.0), peak_output(0), blocked_minutes(0.0) {}
+};
+
+/**
+ * @struct SimulationResult
+ * @brief KPIs and run statistics of one deterministic run
+ */
+struct SimulationResult {
+    double avg_lead_time;
+    double station_utilization;
+    double throughput;                   // Orders per hour
+    double agv_utilization;
+    int completed_orders;
+    int canceled_orders;
+    double makespan_minutes;             // Last completion - first release
+    double station_busy_minutes;
+    double setup_minutes;                // Part of station_busy_minutes spent on changeovers
+    int changeovers;                     // Assemblies that needed a setup
+    int lots;                            // Lots of more than one order started at the station
+    double agv_busy_minutes;             // Summed over the fleet
+    double congestion_delay_minutes;     // Summed over the fleet
+    long long forced_route_entries;      // Congestion routing: aisle entries accepted with a conflict
+    double empty_km;                     // Deadhead travel (to pickups), summed over the fleet
+    double loaded_km;
+    std::vector<AgvStatistics> agv_stats;
+    std::vector<WorkcenterStatistics> workcenter_stats;   // Empty without routings
+    int wip_moves;                       // AGV trips carrying work in process between operations
+    double station_blocked_minutes;      // Slot-minutes held by assembled jobs (station output buffer full)
+    int unfinished_jobs;                 // Routed orders left blocked when the run ended (buffer deadlock)
+    long long events_processed;
+    uint64_t trace_hash;                 // FNV-1a over the full event sequence
+    long long dispatch_cycles;
+    double avg_cycle_solve_us;           // Wall-clock assignment solve time per cycle
+    int backhaul_trips;                  // Finished products carried on a component AGV's return leg
+    double charging_minutes;             // Fleet time out of service for charging (battery model)
+    double charger_wait_minutes;         // Part of it spent queuing for a free charger
+    int charges;                         // Charging sessions started
+    double min_soc;                      // Lowest state of charge reached by any AGV (percent)
+
+    SimulationResult()
+        : avg_lead_time(0.0), station_utilization(0.0), throughput(0.0), agv_utilization(0.0),
+          completed_orders(0), canceled_orders(0), makespan_minutes(0.0),
+          station_busy_minutes(0.0), setup_minutes(0.0), changeovers(0), lots(0), agv_busy_minutes(0.0), congestion_delay_minutes(0.0),
+          forced_route_entries(0), empty_km(0.0), loaded_km(0.0), wip_moves(0), station_blocked_minutes(0.0), unfinished_jobs(0),
+          events_processed(0), trace_hash(0),
+          dispatch_cycles(0), avg_cycle_solve_us(0.0), backhaul_trips(0),
+          charging_minutes(0.0), charger_wait_minutes(0.0), charges(0), min_soc(100.0) {}
+};
+/*************************************************************************************/
+
+/****************************DiscreteEventSimulator Class*****************************/
+/**
+ * @class DiscreteEventSimulator
+ * @brief Event-queue model of the cell with a virtual clock and no threads
+ *
+ * Events are ordered by (time, insertion sequence), so the same inputs and
+ * seed always produce the same event sequence, KPIs and trace hash. The
+ * station selects the next queued order according to the scheduling policy
+ * whenever one of its slots is free; each slot waits for its own
+ * components and assembles one order at a time, paying the changeover
+ * from its previous product when a setup matrix is given. Products with a
+ * routing then visit their workcenters in order: each workcenter has its
+ * own machines and queue, and AGVs carry the work in process between them.
+ * With finite buffers a finished job that finds its output buffer full
+ * keeps its machine (or station slot) blocked, and a job only leaves once
+ * its next workcenter has input space for it.
+ * Random durations come from counter-based streams per AGV and activity and
+ * per order (assembly), so equal seeds give common random numbers across
+ * configurations.
+ */
+class DiscreteEventSimulator {
+public:
+    typedef std::function<void(double, const std::string&)> Logger;
+
+    explicit DiscreteEventSimulator(const SimulationConfig& cfg);
+
+    void set_logger(const Logger& fn) { logger = fn; }
+    void set_time_series(KpiTimeSeries* series, const std::vector<std::string>& tracked_skus);
+
+    SimulationResult run(std::vector<Order>& orders,
+                         const std::map<std::string, Product>& products,
+                         const std::map<std::string, int>& inventory);
+
+private:
+    enum EventType {
+        ORDER_RELEASE,
+        STATION_RETRY,
+        STATION_DONE,
+        AGV_LEG_DONE,
+        DISPATCH_CYCLE,
+        LOT_CLOSE,
+        OPERATION_DONE
+    };
+
+    struct Event {
+        double time;
+        uint64_t seq;
+        EventType type;
+        int entity;                      // Order index or AGV index
+
+        bool operator>(const Event& other) const {
+            if (time != other.time) return time > other.time;
+            return seq > other.seq;
+        }
+    };
+
+    struct TransportTask {
+        const std::string* item_id;      // Component ID, or product ID for finished goods
+        bool is_finished_product;
+        int pickup_node;                 // Layout nodes (-1 without layout)
+        int dropoff_node;
+        uint64_t capable;                // Vehicle types allowed to carry the item (bit per type)
+        int slot;                        // Station slot waiting for the component, -1 for finished products
+        int quantity;                    // Units carried (a lot's orders travel together)
+        int job;                         // Order moved between operations (work in process), -1 otherwise
+        int workcenter;                  // Its destination workcenter
+        int buffered_job;                // Order whose output-buffer place the pickup frees, -1 if none
+        int source;                      // Workcenter it is picked up from (-1 station)
+    };
+
+    enum ChargePhase { CHARGE_DRIVING, CHARGE_QUEUED, CHARGE_PLUGGED };
+
+    struct Vehicle {
+        AGVState state;
+        TransportTask task;
+        double task_start;
+        double busy_minutes;
+        double congestion_minutes;
+        double empty_m;                  // Layout distance driven without / with a load
+        double loaded_m;
+        int operations;
+        int location;                    // Layout node after the last drop-off
+        double speed;                    // Vehicle type speed factor (travel time divisor)
+        bool backhaul;                   // Current task continues a component delivery (RETURNING leg)
+        uint64_t leg_event;              // Sequence of the pending AGV_LEG_DONE (others are stale)
+        double soc;                      // State of charge (percent, battery model)
+        double min_soc;
+        ChargePhase charge_phase;        // Sub-state while CHARGING
+        bool opportunity_charge;         // Plugged in while idle; may be unplugged for work
+        double charge_begin;             // Left service for charging
+        double plug_time;                // Plugged in (or queued, while CHARGE_QUEUED)
+        double charging_minutes;
+        RandomStream leg_streams[4];     // TO_WAREHOUSE, PICKING, TO_STATION, DROPPING
+    };
+
+    // Entity kinds and activities used to address random streams
+    enum StreamKind { STREAM_AGV = 1, STREAM_ORDER = 2 };
+
+    struct QueuedOrder {
+        double key;                      // Policy key (smaller first)
+        uint64_t seq;
+        int order_index;
+
+        bool operator>(const QueuedOrder& other) const {
+            if (key != other.key) return key > other.key;
+            return seq > other.seq;
+        }
+    };
+
+    enum SlotState { SLOT_IDLE, SLOT_WAITING_COMPONENTS, SLOT_ASSEMBLING, SLOT_BLOCKED };
+
+    struct StationSlot {
+        SlotState state;
+        int order;                       // Order index being served, -1 if none
+        int pending_units;               // Component units still in transit to this slot
+        const std::string* last_product; // Product assembled last, nullptr before the first order
+    };
+
+    /**
+     * @struct RoutedOperation
+     * @brief A routing step resolved to workcenter indices
+     */
+    struct RoutedOperation {
+        const Operation* op;
+        std::vector<int> centers;        // Eligible workcenters
+    };
+
+    /**
+     * @struct Occupancy
+     * @brief Level of a buffer with its time integral and peak
+     */
+    struct Occupancy {
+        int count;
+        int peak;
+        double area;                     // Job-minutes
+        double since;                    // Time of the last change
+
+        void change(double now, int delta) {
+            area += count * (now - since);
+            since = now;
+            count += delta;
+            if (count > peak) peak = count;
+        }
+    };
+
+    /**
+     * @struct OutputBuffer
+     * @brief Finished jobs waiting for pickup, and the ones still blocking their machine
+     */
+    struct OutputBuffer {
+        int capacity;                    // -1: unlimited
+        Occupancy held;
+        std::deque<int> blocked;         // Orders holding their machine or slot, in finishing order
+        double blocked_minutes;
+
+        bool has_space() const { return capacity < 0 || held.count < capacity; }
+    };
+
+    struct WorkcenterState {
+        const Workcenter* spec;
+        int node;                        // Layout node (-1 without layout)
+        int machines_free;
+        int inbound;                     // Jobs on their way here
+        std::priority_queue<QueuedOrder, std::vector<QueuedOrder>, std::greater<QueuedOrder> > queue;
+        Occupancy queued;                // Input buffer (jobs in the queue)
+        OutputBuffer out;
+        std::deque<int> space_waiters;   // Orders waiting upstream for input space here (stale entries skipped)
+        double busy;                     // Machine-minutes
+        double wait;                     // Summed queue wait
+        int operations;
+    };
+
+    SimulationConfig config;
+    Logger logger;
+    KpiTimeSeries* time_series;
+    std::vector<std::string> series_skus;
+
+    // Run state
+    double now;
+    uint64_t next_seq;
+    uint64_t trace;
+    long long events;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event> > event_queue;
+    std::vector<Order>* orders;
+    std::vector<const Product*> order_products;    // Resolved BOM per order (nullptr if unknown)
+    Warehouse* warehouse;
+
+    std::priority_queue<QueuedOrder, std::vector<QueuedOrder>, std::greater<QueuedOrder> > station_queue;
+    std::vector<StationSlot> slots;
+    bool station_retry_wait;             // After a shortage no order starts until STATION_RETRY
+    int waiting_slots;                   // Slots waiting for components
+    double station_busy;                 // Slot-minutes spent assembling
+    double station_setup;                // Part of it spent on changeovers
+    int changeovers;
+    std::vector<int> retry_counts;
+    LotBatcher batcher;
+    std::vector<std::vector<int> > lot_members;    // Per order: the lot it leads (empty: not batched)
+    int lots_started;
+    std::vector<double> completion_times;           // Exact completion time per order
+
+    // Routings (per-workcenter queues)
+    std::vector<WorkcenterState> centers;
+    std::vector<std::vector<RoutedOperation> > routes;   // Per routed product
+    std::vector<int> order_route;        // Per order: its route, -1 for assembly only
+    std::vector<int> order_step;         // Per order: routing step in progress or next
+    std::vector<int> order_center;       // Per order: workcenter holding it (-1 station)
+    std::vector<double> queued_since;    // Per order: arrival in its workcenter queue
+    std::vector<double> blocked_since;   // Per order: start of blocking its machine, -1 if not blocking
+    std::vector<char> awaiting_space;    // Per order: finished, waiting for input space downstream
+    OutputBuffer station_out;
+    int wip_moves;
+
+    std::deque<TransportTask> transport_queue;
+    std::deque<TransportTask> outbound;             // Finished products waiting for a backhaul
+    int backhaul_trips;
+
+    // Charging (battery model)
+    int charger_node;                    // Layout node of the chargers, -1 without layout
+    int chargers_free;
+    int opportunity_driving;             // Idle AGVs on their way to a free charger
+    std::deque<int> charger_queue;       // AGVs waiting for a charger, in arrival order
+    double charger_wait;
+    int charges;
+    std::vector<Vehicle> fleet;
+    int idle_vehicles;
+    size_t rr_index;                     // Round-robin start for component tasks
+    std::unique_ptr<RoutePlanner> planner;          // Congestion routing, null if disabled
+    std::unique_ptr<FleetIndex> idle_index;         // Nearest capable vehicle, null without layout and fleet profile
+
+    // Dispatch cycles (joint assignment)
+    bool cycle_scheduled;
+    AssignmentSolver cycle_solver;
+    std::vector<int> cycle_agvs;
+    std::vector<size_t> cycle_tasks;                // Queue positions of the cycle's rows
+    std::vector<double> cycle_cost;
+    long long dispatch_cycles;
+    double cycle_solve_seconds;
+
+    void schedule(double time, EventType type, int entity);
+    void trace_event(const Event& ev);
+    void log(const std::string& message);
+    void diag(const std::string& message);
+
+    double queue_key(int order_index, double process_minutes) const;
+    void enqueue_order(int order_index);
+    int lot_size(int order_index) const;
+    int base_time(int order_index) const;
+    int operation_time(int order_index) const;
+    int setup_time(const std::string* previous, int order_index) const;
+    double sample_assembly_time(int order_index, int nominal, uint32_t activity = 0) const;
+    int pop_next_order(int slot);
+    void start_assembly(int slot);
+    void station_try_start();
+    void station_complete(int order_index);
+    void close_lot(const Lot& lot);
+    void build_routes(const std::map<std::string, Product>& products);
+    void complete_order(int order_index, int from_center);
+    OutputBuffer& output_of(int center) { return center >= 0 ? centers[center].out : station_out; }
+    bool has_input_space(int center) const;
+    void depart(int order_index, int from_center);
+    bool route_next(int order_index, int from_center);
+    void wait_for_space(int order_index);
+    void admit_waiting(int center);
+    void picked_up(int order_index, int from_center);
+    void release_holder(int order_index, int from_center);
+    void workcenter_arrive(int center, int order_index);
+    void workcenter_try_start(int center);
+    void operation_complete(int order_index);
+    TransportTask make_task(const std::string& item_id, bool is_finished_product) const;
+    uint64_t capable_types(const std::string& item_id, int quantity) const;
+    double travel_minutes(int agv, AGVState leg) const;
+    double congestion_delay(int agv, AGVState leg);
+    void dispatch_transports();
+    void run_dispatch_cycle();
+    void assign_vehicle(int agv, const TransportTask& task);
+    bool start_backhaul(int agv);
+    void release_outbound();
+    void schedule_leg(int agv, double time);
+    void drain(Vehicle& v, AGVState leg, double minutes);
+    void send_to_charger(int agv, bool opportunity);
+    void plug_in(int agv);
+    void plug_waiting();
+    void finish_charge(int agv);
+    bool unplug_for_work();
+    void on_charge_event(int agv);
+    void start_leg(int agv, AGVState leg);
+    void on_leg_done(int agv);
+};
+/*************************************************************************************/
+#endif /* DISCRETE_EVENT_SIMULATOR_H */
@@ -0,0 +1,185 @@
+/**
+ * @file Distribution.cpp
+ * @brief Process-time distribution implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "Distribution.h"
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+/*************************************************************************************/
+
+/****************************Helper Functions*****************************************/
+namespace {
+/**
+ * @brief Inverse standard normal CDF (Acklam's rational approximation, |rel err| < 1.2e-9)
+ */
+double inverse_normal_cdf(double p) {
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00 };
+    const double p_low = 0.02425;
+
+    if (p < p_low) {
+        double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    if (p > 1 - p_low) {
+        double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+}
+/*************************************************************************************/
+
+/****************************Distribution Methods*************************************/
+/**
+ * @brief Constant duration
+ */
+Distribution Distribution::fixed(double value) {
+    Distribution d;
+    d.kind = FIXED;
+    d.a = value;
+    return d;
+}
+
+
+/**
+ * @brief Triangular distribution on [min, max] with the given mode
+ */
+Distribution Distribution::triangular(double min, double mode, double max) {
+    Distribution d;
+    if (max <= min) return fixed(min);
+    d.kind = TRIANGULAR;
+    d.a = min;
+    d.b = std::min(std::max(mode, min), max);
+    d.c = max;
+    return d;
+}
+
+
+/**
+ * @brief Lognormal distribution given its mean and coefficient of variation
+ */
+Distribution Distribution::lognormal(double mean, double cv) {
+    if (cv <= 0.0 || mean <= 0.0) return fixed(mean);
+    Distribution d;
+    d.kind = LOGNORMAL;
+    double sigma2 = std::log(1.0 + cv * cv);
+    d.a = std::log(mean) - sigma2 / 2.0;   // mu
+    d.b = std::sqrt(sigma2);               // sigma
+    d.c = mean;
+    return d;
+}
+
+
+/**
+ * @brief Empirical distribution from observed durations
+ */
+Distribution Distribution::empirical(const std::vector<double>& observations) {
+    if (observations.empty()) return fixed(0.0);
+    if (observations.size() == 1) return fixed(observations[0]);
+    Distribution d;
+    d.kind = EMPIRICAL;
+    d.values = observations;
+    std::sort(d.values.begin(), d.values.end());
+    return d;
+}
+
+
+/**
+ * @brief Draw a value by inverse CDF
+ * @param u Uniform variate in (0, 1)
+ * @return Sampled duration
+ */
+double Distribution::sample(double u) const {
+    switch (kind) {
+        case TRIANGULAR: {
+            double fc = (b - a) / (c - a);
+            if (u < fc) return a + std::sqrt(u * (c - a) * (b - a));
+            return c - std::sqrt((1.0 - u) * (c - a) * (c - b));
+        }
+        case LOGNORMAL:
+            return std::exp(a + b * inverse_normal_cdf(u));
+        case EMPIRICAL: {
+            double pos = u * (values.size() - 1);
+            size_t i = (size_t)pos;
+            if (i + 1 >= values.size()) return values.back();
+            double frac = pos - i;
+            return values[i] + frac * (values[i + 1] - values[i]);
+        }
+        case FIXED:
+        default:
+            return a;
+    }
+}
+
+
+/**
+ * @brief Expected value of the distribution
+ */
+double Distribution::mean() const {
+    switch (kind) {
+        case TRIANGULAR: return (a + b + c) / 3.0;
+        case LOGNORMAL:  return c;
+        case EMPIRICAL: {
+            double sum = 0.0;
+            for (size_t i = 0; i + 1 < values.size(); ++i) sum += (values[i] + values[i + 1]) / 2.0;
+            return sum / (values.size() - 1);
+        }
+        case FIXED:
+        default:         return a;
+    }
+}
+
+
+/**
+ * @brief Variance of the distribution
+ */
+double Distribution::variance() const {
+    switch (kind) {
+        case TRIANGULAR: return (a * a + b * b + c * c - a * b - a * c - b * c) / 18.0;
+        case LOGNORMAL:  return (std::exp(b * b) - 1.0) * c * c;
+        case EMPIRICAL: {
+            double second = 0.0;
+            for (size_t i = 0; i + 1 < values.size(); ++i) {
+                double x = values[i], y = values[i + 1];
+                second += (x * x + x * y + y * y) / 3.0;
+            }
+            second /= (values.size() - 1);
+            double m = mean();
+            return std::max(0.0, second - m * m);
+        }
+        case FIXED:
+        default:         return 0.0;
+    }
+}
+
+
+/**
+ * @brief Human-readable form, e.g. "triangular(1, 2, 4)"
+ */
+std::string Distribution::describe() const {
+    std::stringstream ss;
+    switch (kind) {
+        case TRIANGULAR: ss << "triangular(" << a << ", " << b << ", " << c << ")"; break;
+        case LOGNORMAL:  ss << "lognormal(mean " << c << ", cv " << std::sqrt(std::exp(b * b) - 1.0) << ")"; break;
+        case EMPIRICAL:  ss << "empirical(" << values.size() << " values, mean " << mean() << ")"; break;
+        case FIXED:
+        default:         ss << "fixed(" << a << ")"; break;
+    }
+    return ss.str();
+}
+/*************************************************************************************/
@@ -0,0 +1,72 @@
+/**
+ * @file Distribution.h
+ * @brief Process-time distributions for AGV and station activities
+ */
+
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+/*************************************************************************************/
+
+/****************************Distribution Class Definition****************************/
+/**
+ * @class Distribution
+ * @brief Duration distribution sampled by inverse CDF from a single uniform
+ *
+ * One uniform per draw keeps common random numbers aligned between
+ * configurations. Supported kinds: fixed value, triangular (min, mode, max),
+ * lognormal (mean, coefficient of variation) and empirical (observed values,
+ * linearly interpolated quantiles).
+ */
+class Distribution {
+public:
+    enum Kind { FIXED, TRIANGULAR, LOGNORMAL, EMPIRICAL };
+
+    Distribution() : kind(FIXED), a(0.0), b(0.0), c(0.0) {}
+
+    static Distribution fixed(double value);
+    static Distribution triangular(double min, double mode, double max);
+    static Distribution lognormal(double mean, double cv);
+    static Distribution empirical(const std::vector<double>& observations);
+
+    double sample(double u) const;   // u in (0, 1)
+    double mean() const;
+    double variance() const;
+    bool is_fixed() const { return kind == FIXED; }
+    Kind get_kind() const { return kind; }
+    std::string describe() const;
+
+private:
+    Kind kind;
+    double a, b, c;                  // FIXED: a | TRIANGULAR: a,b,c | LOGNORMAL: mu, sigma, mean
+    std::vector<double> values;      // EMPIRICAL, sorted
+};
+
+/**
+ * @struct ProcessTimeModel
+ * @brief Distribution per activity (nominal defaults match the AGV constructor)
+ */
+struct ProcessTimeModel {
+    Distribution travel_warehouse;   // Minutes
+    Distribution travel_station;     // Minutes
+    Distribution picking;            // Minutes
+    Distribution dropping;           // Minutes
+    Distribution assembly_factor;    // Multiplier on T_base + T_setup (mean 1 keeps the nominal time)
+
+    ProcessTimeModel()
+        : travel_warehouse(Distribution::fixed(2)),
+          travel_station(Distribution::fixed(3)),
+          picking(Distribution::fixed(1)),
+          dropping(Distribution::fixed(1)),
+          assembly_factor(Distribution::fixed(1)) {}
+
+    bool is_deterministic() const {
+        return travel_warehouse.is_fixed() && travel_station.is_fixed() && picking.is_fixed() &&
+               dropping.is_fixed() && assembly_factor.is_fixed();
+    }
+};
+/*************************************************************************************/
+#endif /* DISTRIBUTION_H */
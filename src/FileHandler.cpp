@@ -5,7 +5,9 @@
 
 /******************************Project Headers*****************************************/
 #include "FileHandler.h"
+#include "BomExplosion.h"
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
@@ -41,10 +43,12 @@ bool FileHandler::read_orders_file(const std::string& filename, std::vector<Orde
         
         std::istringstream iss(line);
         int hour, minute, priority = 0;
+        int due_hour = 0, due_minute = 0;
         std::string product_id;
         
         if (iss >> hour >> minute >> product_id) {
             iss >> priority;  // Optional priority
+            bool has_due = (bool)(iss >> due_hour >> due_minute);  // Optional due time
             
             Order order;
             order.order_id = order_id++;
@@ -53,6 +57,7 @@ bool FileHandler::read_orders_file(const std::string& filename, std::vector<Orde
             order.release_time_minutes = time_to_minutes(hour, minute);
             order.product_id = product_id;
             order.priority = priority;
+            if (has_due) order.due_date_minutes = time_to_minutes(due_hour, due_minute);
             
             orders.push_back(order);
         }
@@ -68,6 +73,10 @@ bool FileHandler::read_orders_file(const std::string& filename, std::vector<Orde
  * @param filename Path to the BOM file
  * @param products Map to populate with read products
  * @return true if successful, false otherwise
+ *
+ * An entry may name another product (`P1 P5 2`): a subassembly built in
+ * the cell. The BOMs are exploded into leaf requirements once loaded;
+ * undefined subassemblies and cycles are errors.
  */
 bool FileHandler::read_bom_file(const std::string& filename, std::map<std::string, Product>& products) {
     std::ifstream file(filename);
@@ -90,7 +99,7 @@ bool FileHandler::read_bom_file(const std::string& filename, std::map<std::strin
         
         // Formats supported:
         // 1) product_id base_time
-        // 2) product_id component_id quantity
+        // 2) product_id component_id|subassembly_id quantity
         // 3) component_id quantity (uses last current_product_id)
         if (tokens.size() == 2 && tokens[0][0] == 'P') {
             // product_id base_time
@@ -102,8 +111,8 @@ bool FileHandler::read_bom_file(const std::string& filename, std::map<std::strin
                 p.product_id = current_product_id;
                 p.base_assembly_time_minutes = base_time;
             }
-        } else if (tokens.size() == 3 && tokens[0][0] == 'P' && tokens[1][0] == 'C') {
-            // product_id component_id quantity
+        } else if (tokens.size() == 3 && tokens[0][0] == 'P' && (tokens[1][0] == 'C' || tokens[1][0] == 'P')) {
+            // product_id component_id|subassembly_id quantity
             std::istringstream qss(tokens[2]);
             int qty = 0;
             if (qss >> qty && qss.eof()) {
@@ -127,6 +136,21 @@ bool FileHandler::read_bom_file(const std::string& filename, std::map<std::strin
     }
     
     file.close();
+
+    for (const auto& product : products) {
+        for (const auto& item : product.second.bom) {
+            if (item.first[0] == 'P' && products.find(item.first) == products.end()) {
+                std::cerr << "Error: " << filename << ": " << product.first << " uses undefined subassembly "
+                          << item.first << std::endl;
+                return false;
+            }
+        }
+    }
+    std::string error;
+    if (!BomExplosion::explode(products, error)) {
+        std::cerr << "Error: " << filename << ": BOM " << error << std::endl;
+        return false;
+    }
     return true;
 }
 
@@ -163,6 +187,426 @@ bool FileHandler::read_warehouse_file(const std::string& filename,
 }
 
 
+/**
+ * @brief Read per-activity process-time distributions from a file
+ * @param filename Path to the distributions file
+ * @param model Model to update; activities not listed keep their current distribution
+ * @return true if successful, false otherwise
+ *
+ * Line format: activity kind parameters...
+ *   activity: travel_warehouse | travel_station | picking | dropping | assembly
+ *   kind:     fixed v | triangular min mode max | lognormal mean cv | empirical v1 v2 ...
+ * For "assembly" the distribution is a multiplier on T_base + T_setup.
+ */
+bool FileHandler::read_distributions_file(const std::string& filename, ProcessTimeModel& model) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string activity, kind;
+        if (!(iss >> activity >> kind)) continue;
+        std::vector<double> params;
+        double v;
+        while (iss >> v) params.push_back(v);
+
+        Distribution dist;
+        if (kind == "fixed" && params.size() == 1) {
+            dist = Distribution::fixed(params[0]);
+        } else if (kind == "triangular" && params.size() == 3) {
+            dist = Distribution::triangular(params[0], params[1], params[2]);
+        } else if (kind == "lognormal" && params.size() == 2) {
+            dist = Distribution::lognormal(params[0], params[1]);
+        } else if (kind == "empirical" && !params.empty()) {
+            dist = Distribution::empirical(params);
+        } else {
+            std::cerr << "Warning: " << filename << ":" << line_no << ": bad distribution '" << line << "'" << std::endl;
+            continue;
+        }
+
+        if (activity == "travel_warehouse") model.travel_warehouse = dist;
+        else if (activity == "travel_station") model.travel_station = dist;
+        else if (activity == "picking") model.picking = dist;
+        else if (activity == "dropping") model.dropping = dist;
+        else if (activity == "assembly") model.assembly_factor = dist;
+        else std::cerr << "Warning: " << filename << ":" << line_no << ": unknown activity '" << activity << "'" << std::endl;
+    }
+
+    file.close();
+    return true;
+}
+
+
+/**
+ * @brief Read the shop-floor layout graph and build its travel-time matrix
+ * @param filename Path to the layout file
+ * @param layout Layout to fill (built on success)
+ * @return true if the file was read and the layout is usable, false otherwise
+ *
+ * Line format (blank lines and '#' comments ignored):
+ *   speed <m_per_min>                       default AGV speed
+ *   headway <minutes>                       min gap between AGVs (congestion routing)
+ *   node <name>                             isolated node (aisles create nodes implicitly)
+ *   aisle <from> <to> <length_m> [speed]    two-way segment
+ *   oneway <from> <to> <length_m> [speed]   one-way segment, from -> to
+ *   warehouse|station|home <node>           role nodes (default WAREHOUSE, STATION, PARK)
+ *   storage <item_id> <node>                pick location of a component or finished product
+ */
+bool FileHandler::read_layout_file(const std::string& filename, Layout& layout) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string keyword;
+        if (!(iss >> keyword)) continue;
+
+        bool ok = true;
+        if (keyword == "speed") {
+            double speed = 0.0;
+            ok = (iss >> speed) && speed > 0.0;
+            if (ok) layout.set_default_speed(speed);
+        } else if (keyword == "headway") {
+            double minutes = 0.0;
+            ok = (iss >> minutes) && minutes >= 0.0;
+            if (ok) layout.set_headway(minutes);
+        } else if (keyword == "node") {
+            std::string name;
+            ok = (bool)(iss >> name);
+            if (ok) layout.add_node(name);
+        } else if (keyword == "aisle" || keyword == "oneway") {
+            std::string from, to;
+            double length = 0.0, speed = 0.0;
+            ok = (bool)(iss >> from >> to >> length);
+            if (ok) {
+                iss >> speed;
+                ok = layout.add_aisle(from, to, length, speed, keyword == "oneway");
+            }
+        } else if (keyword == "warehouse" || keyword == "station" || keyword == "home") {
+            std::string name;
+            ok = (bool)(iss >> name);
+            if (ok && keyword == "warehouse") layout.set_warehouse_node(name);
+            else if (ok && keyword == "station") layout.set_station_node(name);
+            else if (ok) layout.set_home_node(name);
+        } else if (keyword == "storage") {
+            std::string item, name;
+            ok = (bool)(iss >> item >> name);
+            if (ok) layout.set_storage(item, name);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Warning: " << filename << ":" << line_no << ": bad layout line '" << line << "'" << std::endl;
+        }
+    }
+
+    file.close();
+    return layout.build();
+}
+
+
+/**
+ * @brief Read AGV battery and charger parameters (enables the battery model)
+ * @param filename Path to the battery file
+ * @param battery Model to update; keys not listed keep their defaults
+ * @return true if the file was read and the parameters are consistent, false otherwise
+ *
+ * Line format (blank lines and '#' comments ignored), levels in percent:
+ *   initial|threshold|target <level>
+ *   drain_empty|drain_loaded|drain_handling|charge_rate <percent_per_min>
+ *   chargers <count>
+ *   charger <node>                 layout node of the chargers (default home)
+ *   policy threshold|opportunity
+ */
+bool FileHandler::read_battery_file(const std::string& filename, BatteryModel& battery) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string keyword;
+        if (!(iss >> keyword)) continue;
+
+        bool ok = true;
+        double value = 0.0;
+        if (keyword == "initial" || keyword == "threshold" || keyword == "target") {
+            ok = (iss >> value) && value >= 0.0 && value <= 100.0;
+            if (ok && keyword == "initial") battery.initial = value;
+            else if (ok && keyword == "threshold") battery.threshold = value;
+            else if (ok) battery.target = value;
+        } else if (keyword == "drain_empty" || keyword == "drain_loaded" || keyword == "drain_handling") {
+            ok = (iss >> value) && value >= 0.0;
+            if (ok && keyword == "drain_empty") battery.drain_empty = value;
+            else if (ok && keyword == "drain_loaded") battery.drain_loaded = value;
+            else if (ok) battery.drain_handling = value;
+        } else if (keyword == "charge_rate") {
+            ok = (iss >> value) && value > 0.0;
+            if (ok) battery.charge_rate = value;
+        } else if (keyword == "chargers") {
+            int count = 0;
+            ok = (iss >> count) && count > 0;
+            if (ok) battery.chargers = count;
+        } else if (keyword == "charger") {
+            ok = (bool)(iss >> battery.charger_node);
+        } else if (keyword == "policy") {
+            std::string policy;
+            ok = (bool)(iss >> policy) && (policy == "threshold" || policy == "opportunity");
+            if (ok) battery.opportunity = policy == "opportunity";
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Warning: " << filename << ":" << line_no << ": bad battery line '" << line << "'" << std::endl;
+        }
+    }
+    file.close();
+
+    if (battery.threshold >= battery.target) {
+        std::cerr << "Error: " << filename << ": threshold must be below target" << std::endl;
+        return false;
+    }
+    battery.enabled = true;
+    return true;
+}
+
+
+/**
+ * @brief Read the vehicle types of a mixed fleet
+ * @param filename Path to the fleet file
+ * @param profile Profile to fill (built on success)
+ * @return true if at least one vehicle type was read, false otherwise
+ *
+ * Line format (blank lines and '#' comments ignored):
+ *   type <name> <count> <speed_factor> <payload_kg> [item ...]   no items: any item within payload
+ *   weight <item_id> <kg>                                         unlisted items weigh 0
+ */
+bool FileHandler::read_fleet_file(const std::string& filename, FleetProfile& profile) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string keyword;
+        if (!(iss >> keyword)) continue;
+
+        bool ok = true;
+        if (keyword == "type") {
+            VehicleType type;
+            ok = (bool)(iss >> type.name >> type.count >> type.speed_factor >> type.payload_kg);
+            std::string item;
+            while (ok && iss >> item) {
+                if (item[0] == '#') break;
+                type.items.push_back(item);
+            }
+            ok = ok && profile.add_type(type);
+        } else if (keyword == "weight") {
+            std::string item;
+            double kg = 0.0;
+            ok = (iss >> item >> kg) && kg >= 0.0;
+            if (ok) profile.set_weight(item, kg);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Warning: " << filename << ":" << line_no << ": bad fleet line '" << line << "'" << std::endl;
+        }
+    }
+    file.close();
+
+    if (profile.empty()) {
+        std::cerr << "Error: " << filename << ": no vehicle types" << std::endl;
+        return false;
+    }
+    profile.build();
+    return true;
+}
+
+
+/**
+ * @brief Read sequence-dependent setup times
+ * @param filename Path to the setup file
+ * @param setups Matrix to fill
+ * @return true if successful, false otherwise
+ *
+ * Lines: `default MIN`, `family PRODUCT FAMILY` and `setup FROM TO MIN`,
+ * where FROM and TO are product or family IDs.
+ */
+bool FileHandler::read_setup_file(const std::string& filename, SetupMatrix& setups) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string keyword;
+        if (!(iss >> keyword)) continue;
+
+        bool ok = true;
+        int minutes = 0;
+        if (keyword == "default") {
+            ok = (iss >> minutes) && minutes >= 0;
+            if (ok) setups.set_default(minutes);
+        } else if (keyword == "family") {
+            std::string product_id, family;
+            ok = (bool)(iss >> product_id >> family);
+            if (ok) setups.set_family(product_id, family);
+        } else if (keyword == "setup") {
+            std::string from, to;
+            ok = (iss >> from >> to >> minutes) && minutes >= 0;
+            if (ok) setups.set_time(from, to, minutes);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Warning: " << filename << ":" << line_no << ": bad setup line '" << line << "'" << std::endl;
+        }
+    }
+    file.close();
+
+    if (setups.empty()) {
+        std::cerr << "Error: " << filename << ": no setup entries" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+
+/**
+ * @brief Read workcenters and product routings
+ * @param filename Path to the routing file
+ * @param products Products whose routings are appended to (load the BOM first)
+ * @param workcenters Workcenters to fill
+ * @return true if successful, false otherwise
+ *
+ * Lines: `workcenter NAME MACHINES [NODE]`,
+ * `buffer WORKCENTER input|output CAPACITY` (after its workcenter) and
+ * `step PRODUCT OPERATION MINUTES WORKCENTER [WORKCENTER...]`, with each
+ * product's steps in routing order.
+ */
+bool FileHandler::read_routing_file(const std::string& filename, std::map<std::string, Product>& products,
+                                    std::vector<Workcenter>& workcenters) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string keyword;
+        if (!(iss >> keyword)) continue;
+
+        bool ok = true;
+        if (keyword == "workcenter") {
+            Workcenter wc;
+            ok = (iss >> wc.name >> wc.machines) && wc.machines > 0;
+            if (ok && iss >> wc.node && wc.node[0] == '#') wc.node.clear();
+            if (ok) workcenters.push_back(wc);
+        } else if (keyword == "buffer") {
+            std::string name, side;
+            int capacity = 0;
+            ok = (iss >> name >> side >> capacity) && (side == "input" || side == "output") &&
+                 capacity >= (side == "input" ? 1 : 0);   // A job needs an input place to reach a machine
+            Workcenter* target = nullptr;
+            for (auto& wc : workcenters) {
+                if (wc.name == name) target = &wc;
+            }
+            if (ok && !target) {
+                std::cerr << "Warning: " << filename << ":" << line_no << ": unknown workcenter " << name << std::endl;
+                continue;
+            }
+            if (ok) (side == "input" ? target->input_buffer : target->output_buffer) = capacity;
+        } else if (keyword == "step") {
+            std::string product_id;
+            Operation op;
+            ok = (iss >> product_id >> op.name >> op.process_minutes) && op.process_minutes >= 0;
+            std::string wc;
+            while (ok && iss >> wc) {
+                if (wc[0] == '#') break;
+                op.workcenters.push_back(wc);
+            }
+            ok = ok && !op.workcenters.empty();
+            auto it = products.find(product_id);
+            if (ok && it == products.end()) {
+                std::cerr << "Warning: " << filename << ":" << line_no << ": unknown product " << product_id << std::endl;
+                continue;
+            }
+            if (ok) it->second.routing.push_back(op);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Warning: " << filename << ":" << line_no << ": bad routing line '" << line << "'" << std::endl;
+        }
+    }
+    file.close();
+
+    for (const auto& product : products) {
+        for (const auto& op : product.second.routing) {
+            for (const auto& name : op.workcenters) {
+                bool known = false;
+                for (const auto& wc : workcenters) known = known || wc.name == name;
+                if (!known) {
+                    std::cerr << "Error: " << filename << ": " << product.first << " step " << op.name
+                              << " uses undefined workcenter " << name << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    if (workcenters.empty()) {
+        std::cerr << "Error: " << filename << ": no workcenters" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
 
 /**
  * @brief Write KPI report to file
@@ -199,6 +643,76 @@ bool FileHandler::write_kpi_report(const std::string& filename,
 
 
 
+/**
+ * @brief Write per-AGV operations, busy time, congestion delay and travel distance
+ * @param filename Path to the output AGV report file
+ * @param stats One entry per AGV
+ * @return true if successful, false otherwise
+ */
+bool FileHandler::write_agv_report(const std::string& filename,
+                                   const std::vector<AgvStatistics>& stats) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+
+    file << "========================================\n";
+    file << "  AGV Report                           \n";
+    file << "========================================\n\n";
+    file << "AGV     Type      Operations  Busy (min)  Congestion delay (min)  Empty (km)  Loaded (km)  Charging (min)\n";
+
+    AgvStatistics total;
+    for (const auto& agv : stats) {
+        file << std::left << std::setw(8) << ("AGV" + std::to_string(agv.agv_id))
+             << std::setw(10) << (agv.vehicle_type.empty() ? "-" : agv.vehicle_type) << std::right
+             << std::setw(10) << agv.operations
+             << std::setw(12) << std::fixed << std::setprecision(1) << agv.busy_minutes
+             << std::setw(24) << agv.congestion_delay_minutes
+             << std::setw(12) << std::setprecision(3) << agv.empty_km
+             << std::setw(13) << agv.loaded_km
+             << std::setw(16) << std::setprecision(1) << agv.charging_minutes << "\n";
+        total.operations += agv.operations;
+        total.busy_minutes += agv.busy_minutes;
+        total.congestion_delay_minutes += agv.congestion_delay_minutes;
+        total.empty_km += agv.empty_km;
+        total.loaded_km += agv.loaded_km;
+        total.charging_minutes += agv.charging_minutes;
+    }
+    file << std::left << std::setw(18) << "Total" << std::right << std::setw(10) << total.operations
+         << std::setw(12) << std::setprecision(1) << total.busy_minutes
+         << std::setw(24) << total.congestion_delay_minutes
+         << std::setw(12) << std::setprecision(3) << total.empty_km
+         << std::setw(13) << total.loaded_km
+         << std::setw(16) << std::setprecision(1) << total.charging_minutes << "\n";
+
+    file.close();
+    return true;
+}
+
+
+/**
+ * @brief Write the pre-run material requirements report
+ * @param filename Path to the output MRP report file
+ * @param plan Result of the MRP pass
+ * @return true if successful, false otherwise
+ */
+bool FileHandler::write_mrp_report(const std::string& filename, const MaterialPlan& plan) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+
+    file << "========================================\n";
+    file << "  Material Requirements Report         \n";
+    file << "========================================\n\n";
+    file << MaterialPlanner::format_report(plan);
+    return true;
+}
+
+
+
 /**
  * @brief Check if a file exists
  * @param filename Path to the file
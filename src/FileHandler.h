@@ -9,6 +9,13 @@
 /******************************Project Headers*****************************************/
 #include "Order.h"
 #include "Product.h"
+#include "Distribution.h"
+#include "Layout.h"
+#include "Battery.h"
+#include "FleetProfile.h"
+#include "SetupMatrix.h"
+#include "AGV.h"
+#include "MaterialPlanner.h"
 #include <string>
 #include <vector>
 /**************************************************************************************/
@@ -26,6 +33,13 @@ public:
     static bool read_bom_file(const std::string& filename, std::map<std::string, Product>& products);
     static bool read_warehouse_file(const std::string& filename, 
                                      std::map<std::string, int>& inventory);
+    static bool read_distributions_file(const std::string& filename, ProcessTimeModel& model);
+    static bool read_layout_file(const std::string& filename, Layout& layout);
+    static bool read_battery_file(const std::string& filename, BatteryModel& battery);
+    static bool read_fleet_file(const std::string& filename, FleetProfile& profile);
+    static bool read_setup_file(const std::string& filename, SetupMatrix& setups);
+    static bool read_routing_file(const std::string& filename, std::map<std::string, Product>& products,
+                                  std::vector<Workcenter>& workcenters);
     
     // Output file writers
     static bool write_kpi_report(const std::string& filename,
@@ -33,6 +47,9 @@ public:
                                   double station_utilization,
                                   double throughput,
                                   double agv_utilization);
+    static bool write_agv_report(const std::string& filename,
+                                  const std::vector<AgvStatistics>& stats);
+    static bool write_mrp_report(const std::string& filename, const MaterialPlan& plan);
     
     // Utility functions
     static bool file_exists(const std::string& filename);
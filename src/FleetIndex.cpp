@@ -0,0 +1,184 @@
+/**
+ * @file FleetIndex.cpp
+ * @brief Nearest idle AGV index implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "FleetIndex.h"
+#include <limits>
+#include <algorithm>
+/*************************************************************************************/
+
+namespace {
+// Below this many occupied nodes, compare them directly instead of walking the ring
+const size_t DIRECT_SCAN_NODES = 32;
+}
+
+/****************************FleetIndex Methods**************************************/
+const uint64_t FleetIndex::ANY_TYPE;   // Bound by reference (e.g. vector fill), so it needs a definition
+
+/**
+ * @brief Constructor for FleetIndex
+ * @param floor Built layout (must outlive the index), or nullptr for position-free dispatch
+ */
+FleetIndex::FleetIndex(const Layout* floor)
+    : layout(floor),
+      idle_total(0) {
+}
+
+
+/**
+ * @brief Empty the index and size it for a fleet of one vehicle type
+ */
+void FleetIndex::reset(int fleet_size) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    node_of.assign(std::max(fleet_size, 0), -1);
+    type_of.assign(node_of.size(), 0);
+    type_speed.assign(1, 1.0);
+    clear_buckets(1);
+}
+
+
+/**
+ * @brief Assign vehicle types to the fleet slots (call after reset, before add_idle)
+ * @param slot_types Type index per slot
+ * @param speed_factors Speed factor per type
+ */
+void FleetIndex::set_vehicle_types(const std::vector<int>& slot_types, const std::vector<double>& speed_factors) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    type_speed = speed_factors.empty() ? std::vector<double>(1, 1.0) : speed_factors;
+    for (size_t slot = 0; slot < type_of.size(); ++slot) {
+        int type = slot < slot_types.size() ? slot_types[slot] : 0;
+        type_of[slot] = (type >= 0 && type < (int)type_speed.size()) ? type : 0;
+    }
+    std::fill(node_of.begin(), node_of.end(), -1);
+    clear_buckets((int)type_speed.size());
+}
+
+
+void FleetIndex::clear_buckets(int types) {
+    idle_at.assign(types, std::vector<std::set<int> >(node_total()));
+    occupied.assign(types, std::set<int>());
+    idle_of_type.assign(types, 0);
+    idle_total = 0;
+}
+
+
+/**
+ * @brief Register an idle AGV at a node (ignored without a layout)
+ */
+void FleetIndex::add_idle(int slot, int node) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    if (!layout) node = 0;
+    if (slot < 0 || slot >= (int)node_of.size() || node < 0 || node_of[slot] >= 0) return;
+    int type = type_of[slot];
+    node_of[slot] = node;
+    idle_at[type][node].insert(slot);
+    occupied[type].insert(node);
+    idle_of_type[type]++;
+    idle_total++;
+}
+
+
+/**
+ * @brief Remove an AGV from the index
+ * @return false if it was not idle
+ */
+bool FleetIndex::remove_idle(int slot) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    if (slot < 0 || slot >= (int)node_of.size() || node_of[slot] < 0) return false;
+    int type = type_of[slot];
+    int node = node_of[slot];
+    idle_at[type][node].erase(slot);
+    if (idle_at[type][node].empty()) occupied[type].erase(node);
+    node_of[slot] = -1;
+    idle_of_type[type]--;
+    idle_total--;
+    return true;
+}
+
+
+/**
+ * @brief Take the capable idle AGV with the earliest arrival at a node
+ * @param target Pickup node (ignored without a layout)
+ * @param capable Bit t set if vehicle type t may carry the item
+ * @param eta Optional output: empty travel time of the chosen AGV
+ * @return Slot of the claimed AGV (no longer idle in the index), or -1 if none can reach the target
+ */
+int FleetIndex::claim_nearest(int target, uint64_t capable, double* eta) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    if (!layout) target = 0;
+    if (idle_total == 0 || target < 0) return -1;
+
+    int best_type = -1;
+    int best_node = -1;
+    double best = std::numeric_limits<double>::infinity();
+    for (int type = 0; type < (int)idle_of_type.size(); ++type) {
+        if (idle_of_type[type] == 0 || !((capable >> type) & 1)) continue;
+        int node = nearest_node(type, target);
+        if (node < 0) continue;
+        double t = travel_time(node, target) / type_speed[type];
+        if (t < best || (t == best && type_speed[type] > type_speed[best_type])) {
+            best = t;
+            best_type = type;
+            best_node = node;
+        }
+    }
+    if (best_type < 0) return -1;
+
+    std::set<int>& bucket = idle_at[best_type][best_node];
+    int slot = *bucket.begin();
+    bucket.erase(bucket.begin());
+    if (bucket.empty()) occupied[best_type].erase(best_node);
+    node_of[slot] = -1;
+    idle_of_type[best_type]--;
+    idle_total--;
+    if (eta) *eta = best;
+    return slot;
+}
+
+
+int FleetIndex::idle_count() const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    return idle_total;
+}
+
+
+/**
+ * @brief Node of the type's idle AGV closest to the target, -1 if none can reach it
+ */
+int FleetIndex::nearest_node(int type, int target) {
+    const std::set<int>& nodes = occupied[type];
+    if (nodes.size() <= DIRECT_SCAN_NODES) {
+        int best_node = -1;
+        double best = std::numeric_limits<double>::infinity();
+        for (int node : nodes) {   // Ascending node index: ties keep the lower one
+            double t = travel_time(node, target);
+            if (t < best) { best = t; best_node = node; }
+        }
+        return best_node;
+    }
+    for (int node : nodes_by_travel_time(target)) {
+        if (!idle_at[type][node].empty()) return node;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Nodes that can reach the target, by (travel time, node index)
+ */
+const std::vector<int>& FleetIndex::nodes_by_travel_time(int target) {
+    auto it = rings.find(target);
+    if (it != rings.end()) return it->second;
+
+    std::vector<int>& ring = rings[target];
+    for (int node = 0; node < node_total(); ++node) {
+        if (!layout || layout->reachable(node, target)) ring.push_back(node);
+    }
+    std::stable_sort(ring.begin(), ring.end(), [this, target](int a, int b) {
+        return travel_time(a, target) < travel_time(b, target);
+    });
+    return ring;
+}
+/*************************************************************************************/
@@ -0,0 +1,73 @@
+/**
+ * @file FleetIndex.h
+ * @brief Spatial index of idle AGVs for nearest-vehicle dispatching
+ */
+
+#ifndef FLEET_INDEX_H
+#define FLEET_INDEX_H
+
+/******************************Project Headers*****************************************/
+#include "Layout.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <set>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+/*************************************************************************************/
+
+/****************************FleetIndex Class Definition******************************/
+/**
+ * @class FleetIndex
+ * @brief Idle AGVs bucketed by vehicle type and layout node
+ *
+ * claim_nearest() walks the nodes in order of travel time to the pickup
+ * (a per-target list cached on first use) and takes the lowest slot in the
+ * first occupied bucket. When only a few nodes hold idle AGVs they are
+ * compared directly instead. Either way the cost depends on the layout, not
+ * on the fleet size. Ties go to the node with the lower index, then to the
+ * lower slot, so dispatching is deterministic.
+ *
+ * With vehicle types, the search runs once per type allowed by the task's
+ * capability mask, and the type with the earliest arrival (travel time over
+ * its speed factor) wins; equal arrivals go to the faster type. Without a
+ * layout all AGVs share one position, so the fastest idle capable type wins.
+ *
+ * Thread-safe: AGV threads add themselves when they become idle and the
+ * dispatcher claims them.
+ */
+class FleetIndex {
+public:
+    static const uint64_t ANY_TYPE = ~(uint64_t)0;
+
+    explicit FleetIndex(const Layout* floor);
+
+    void reset(int fleet_size);
+    void set_vehicle_types(const std::vector<int>& slot_types, const std::vector<double>& speed_factors);
+    void add_idle(int slot, int node);
+    bool remove_idle(int slot);
+    int claim_nearest(int target, uint64_t capable = ANY_TYPE, double* eta = nullptr);
+    int idle_count() const;
+
+private:
+    const Layout* layout;                           // nullptr: every AGV at one position
+    mutable std::mutex index_mutex;
+    std::vector<std::vector<std::set<int> > > idle_at;  // Type -> node -> idle slots
+    std::vector<std::set<int> > occupied;           // Type -> nodes with at least one idle AGV
+    std::vector<int> idle_of_type;
+    std::vector<double> type_speed;
+    std::vector<int> node_of;                       // Slot -> node, -1 if not idle
+    std::vector<int> type_of;                       // Slot -> vehicle type
+    std::unordered_map<int, std::vector<int> > rings;   // Target -> nodes by travel time to it
+    int idle_total;
+
+    int node_total() const { return layout ? layout->node_count() : 1; }
+    double travel_time(int from, int to) const { return layout ? layout->travel_time(from, to) : 0.0; }
+    void clear_buckets(int types);
+    int nearest_node(int type, int target);
+    const std::vector<int>& nodes_by_travel_time(int target);
+};
+/*************************************************************************************/
+#endif /* FLEET_INDEX_H */
@@ -0,0 +1,112 @@
+/**
+ * @file FleetProfile.cpp
+ * @brief Vehicle type profiles implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "FleetProfile.h"
+#include <algorithm>
+#include <iostream>
+#include <climits>
+#include <cmath>
+/*************************************************************************************/
+
+/****************************FleetProfile Methods************************************/
+/**
+ * @brief Append a vehicle type
+ * @return false if the type is invalid or the type limit is reached
+ */
+bool FleetProfile::add_type(const VehicleType& type) {
+    if ((int)types.size() >= MAX_TYPES) {
+        std::cerr << "Error: at most " << MAX_TYPES << " vehicle types are supported" << std::endl;
+        return false;
+    }
+    if (type.count <= 0 || type.speed_factor <= 0.0 || type.payload_kg < 0.0) return false;
+    types.push_back(type);
+    return true;
+}
+
+
+/**
+ * @brief Assign fleet slots and precompute the capability masks
+ *
+ * Call after all types and weights are added.
+ */
+void FleetProfile::build() {
+    slot_types.clear();
+    for (size_t t = 0; t < types.size(); ++t) {
+        slot_types.insert(slot_types.end(), types[t].count, (int)t);
+    }
+
+    masks.clear();
+    for (const auto& type : types) {
+        for (const auto& item : type.items) masks[item] = 0;
+    }
+    for (const auto& w : weights) masks[w.first] = 0;
+    for (auto& entry : masks) {
+        for (size_t t = 0; t < types.size(); ++t) {
+            if (can_carry(types[t], entry.first)) entry.second |= (uint64_t)1 << t;
+        }
+    }
+
+    default_mask = 0;
+    for (size_t t = 0; t < types.size(); ++t) {
+        if (types[t].items.empty()) default_mask |= (uint64_t)1 << t;
+    }
+}
+
+
+/**
+ * @brief Speed factor of every type, by type index
+ */
+std::vector<double> FleetProfile::speeds() const {
+    std::vector<double> result;
+    for (const auto& type : types) result.push_back(type.speed_factor);
+    return result;
+}
+
+
+/**
+ * @brief Types that may carry an item (bit t = type t); 0 if none can
+ */
+uint64_t FleetProfile::capability_mask(const std::string& item_id) const {
+    auto it = masks.find(item_id);
+    return it != masks.end() ? it->second : default_mask;
+}
+
+
+/**
+ * @brief Types that may carry `quantity` units of an item in one trip (payload against their total weight)
+ */
+uint64_t FleetProfile::capability_mask(const std::string& item_id, int quantity) const {
+    uint64_t mask = capability_mask(item_id);
+    auto w = weights.find(item_id);
+    if (quantity <= 1 || w == weights.end() || w->second <= 0.0) return mask;
+    for (size_t t = 0; t < types.size(); ++t) {
+        if (quantity * w->second > types[t].payload_kg) mask &= ~((uint64_t)1 << t);
+    }
+    return mask;
+}
+
+
+/**
+ * @brief Most units of an item one trip can carry on its largest capable type (INT_MAX if it weighs nothing)
+ */
+int FleetProfile::max_units(const std::string& item_id) const {
+    auto w = weights.find(item_id);
+    if (w == weights.end() || w->second <= 0.0) return INT_MAX;
+    uint64_t mask = capability_mask(item_id);
+    double most = 1.0;
+    for (size_t t = 0; t < types.size(); ++t) {
+        if ((mask >> t) & 1) most = std::max(most, std::floor(types[t].payload_kg / w->second));
+    }
+    return most < INT_MAX ? (int)most : INT_MAX;
+}
+
+
+bool FleetProfile::can_carry(const VehicleType& type, const std::string& item_id) const {
+    auto w = weights.find(item_id);
+    if (w != weights.end() && w->second > type.payload_kg) return false;
+    return type.items.empty() || std::find(type.items.begin(), type.items.end(), item_id) != type.items.end();
+}
+/*************************************************************************************/
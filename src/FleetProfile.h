@@ -0,0 +1,73 @@
+/**
+ * @file FleetProfile.h
+ * @brief Vehicle types of a mixed AGV fleet and what each type may carry
+ */
+
+#ifndef FLEET_PROFILE_H
+#define FLEET_PROFILE_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+/*************************************************************************************/
+
+/*****************************VehicleType Structure Definition*************************/
+/**
+ * @struct VehicleType
+ * @brief One vehicle profile (tugger, forklift, cart, ...)
+ */
+struct VehicleType {
+    std::string name;
+    int count;                           // Vehicles of this type in the fleet
+    double speed_factor;                 // Travel speed relative to nominal (2.0 = twice as fast)
+    double payload_kg;
+    std::vector<std::string> items;      // Permitted items, empty = any item within payload
+
+    VehicleType() : count(0), speed_factor(1.0), payload_kg(0.0) {}
+};
+/*************************************************************************************/
+
+/****************************FleetProfile Class Definition****************************/
+/**
+ * @class FleetProfile
+ * @brief Vehicle types, fleet slot assignment and per-item capability bitmasks
+ *
+ * Fleet slots are numbered type by type in file order. Bit t of an item's
+ * capability mask is set when type t may carry it (permitted and within
+ * payload). Masks are computed once in build(), so a dispatcher filters
+ * candidate types with one AND instead of checking vehicles.
+ */
+class FleetProfile {
+public:
+    static const int MAX_TYPES = 64;
+
+    FleetProfile() : default_mask(0) {}
+
+    bool add_type(const VehicleType& type);
+    void set_weight(const std::string& item_id, double kg) { weights[item_id] = kg; }
+    void build();
+
+    bool empty() const { return types.empty(); }
+    int type_count() const { return (int)types.size(); }
+    const VehicleType& get_type(int t) const { return types[t]; }
+    int fleet_size() const { return (int)slot_types.size(); }
+    int type_of_slot(int slot) const { return slot_types[slot]; }
+    std::vector<double> speeds() const;
+    uint64_t capability_mask(const std::string& item_id) const;
+    uint64_t capability_mask(const std::string& item_id, int quantity) const;
+    int max_units(const std::string& item_id) const;
+
+private:
+    std::vector<VehicleType> types;
+    std::map<std::string, double> weights;           // Item -> kg (unlisted items weigh 0)
+    std::vector<int> slot_types;                     // Fleet slot -> type
+    std::unordered_map<std::string, uint64_t> masks; // Items named in the profile
+    uint64_t default_mask;                           // Any other item: unrestricted types
+
+    bool can_carry(const VehicleType& type, const std::string& item_id) const;
+};
+/*************************************************************************************/
+#endif /* FLEET_PROFILE_H */
@@ -0,0 +1,180 @@
+/**
+ * @file KpiTimeSeries.cpp
+ * @brief Time-windowed KPI accumulator implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "KpiTimeSeries.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+/*************************************************************************************/
+
+/****************************KpiTimeSeries Methods************************************/
+/**
+ * @brief Constructor for KpiTimeSeries (disabled until open() succeeds)
+ */
+KpiTimeSeries::KpiTimeSeries()
+    : enabled(false),
+      window_minutes(15),
+      window_start(0),
+      num_tracked_skus(0),
+      completions(0),
+      last_agv_busy_total(0) {
+}
+
+
+/**
+ * @brief Destructor for KpiTimeSeries
+ */
+KpiTimeSeries::~KpiTimeSeries() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+
+/**
+ * @brief Open the CSV output and write the header row
+ * @param filename Path of the CSV file
+ * @param window Window length in simulated minutes
+ * @param start_minutes Simulated time at which the first window begins
+ * @param tracked_skus Component IDs whose stock is reported per window
+ * @return true if the file could be created, false otherwise
+ */
+bool KpiTimeSeries::open(const std::string& filename, int window, int start_minutes,
+                         const std::vector<std::string>& tracked_skus) {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    if (window <= 0) {
+        return false;
+    }
+
+    file.open(filename, std::ios::out);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+
+    window_minutes = window;
+    window_start = start_minutes - (start_minutes % window);  // Align to window boundary
+    num_tracked_skus = tracked_skus.size();
+    completions = 0;
+    last_agv_busy_total = 0;
+    busy_intervals.clear();
+
+    file << "window_start_min,window_end_min,completions,station_busy_frac,"
+         << "agvs_busy,agv_utilization,queue_length";
+    for (const auto& sku : tracked_skus) {
+        file << ",stock_" << sku;
+    }
+    file << "\n";
+    file.flush();
+
+    enabled = true;
+    return true;
+}
+
+
+/**
+ * @brief Close every window that ends at or before the given time
+ * @param minutes Current simulated time
+ */
+void KpiTimeSeries::advance_to(int minutes) {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    advance_locked(minutes);
+}
+
+
+/**
+ * @brief Count an order completion in the window containing the given time
+ * @param minutes Simulated completion time
+ */
+void KpiTimeSeries::record_completion(int minutes) {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    if (!enabled) return;
+    advance_locked(minutes);
+    completions++;
+}
+
+
+/**
+ * @brief Record a station busy interval; it is split across windows on flush
+ * @param start_minutes Start of the operation
+ * @param end_minutes End of the operation
+ */
+void KpiTimeSeries::record_station_busy(int start_minutes, int end_minutes) {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    if (!enabled || end_minutes <= start_minutes) return;
+    busy_intervals.emplace_back(start_minutes, end_minutes);
+}
+
+
+/**
+ * @brief Write all remaining windows up to the given time and close the file
+ * @param end_minutes Simulated time at which the run ended
+ */
+void KpiTimeSeries::finish(int end_minutes) {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    if (!enabled) return;
+    advance_locked(end_minutes);
+    if (end_minutes > window_start || completions > 0) {
+        flush_window();  // Partial last window
+    }
+    enabled = false;
+    file.close();
+}
+
+
+/**
+ * @brief Flush windows until the open window contains the given time
+ * @param minutes Current simulated time
+ */
+void KpiTimeSeries::advance_locked(int minutes) {
+    if (!enabled) return;
+    while (minutes >= window_start + window_minutes) {
+        flush_window();
+    }
+}
+
+
+/**
+ * @brief Write the open window as one CSV row and start the next window
+ */
+void KpiTimeSeries::flush_window() {
+    int window_end = window_start + window_minutes;
+
+    // Station busy slot-minutes overlapping this window
+    long long busy = 0;
+    for (const auto& iv : busy_intervals) {
+        int lo = std::max(iv.first, window_start);
+        int hi = std::min(iv.second, window_end);
+        if (hi > lo) busy += hi - lo;
+    }
+    // Parallel slots can end out of order: drop every interval that lies entirely in the past
+    busy_intervals.erase(std::remove_if(busy_intervals.begin(), busy_intervals.end(),
+                                        [window_end](const std::pair<int, int>& iv) { return iv.second <= window_end; }),
+                         busy_intervals.end());
+
+    KpiSample sample;
+    if (sampler) sampler(sample);
+    sample.stock.resize(num_tracked_skus, 0);
+    int slots = std::max(sample.station_slots, 1);
+
+    long long agv_busy_delta = sample.agv_busy_minutes_total - last_agv_busy_total;
+    last_agv_busy_total = sample.agv_busy_minutes_total;
+    double agv_utilization = (sample.num_agvs > 0)
+        ? (double)agv_busy_delta / ((double)sample.num_agvs * window_minutes) : 0.0;
+
+    file << window_start << "," << window_end << "," << completions << ","
+         << std::fixed << std::setprecision(4) << ((double)busy / ((double)slots * window_minutes)) << ","
+         << sample.agvs_busy << "," << agv_utilization << "," << sample.queue_length;
+    for (int qty : sample.stock) {
+        file << "," << qty;
+    }
+    file << "\n";
+    file.flush();
+
+    completions = 0;
+    window_start = window_end;
+}
+/*************************************************************************************/
@@ -0,0 +1,78 @@
+/**
+ * @file KpiTimeSeries.h
+ * @brief Time-windowed KPI accumulator streamed to a columnar CSV file
+ */
+
+#ifndef KPI_TIME_SERIES_H
+#define KPI_TIME_SERIES_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <fstream>
+#include <functional>
+/*************************************************************************************/
+
+/****************************KpiTimeSeries Definitions********************************/
+/**
+ * @struct KpiSample
+ * @brief Gauges read from the running simulation when a window closes
+ */
+struct KpiSample {
+    int queue_length;                 // Orders waiting at the station
+    int station_slots;                // Station capacity (busy fraction is per slot)
+    int agvs_busy;                    // AGVs not idle at the sampling instant
+    int num_agvs;                     // Fleet size
+    long long agv_busy_minutes_total; // Cumulative AGV busy minutes (delta per window)
+    std::vector<int> stock;           // Stock of each tracked SKU, same order as the header
+
+    KpiSample() : queue_length(0), station_slots(1), agvs_busy(0), num_agvs(0), agv_busy_minutes_total(0) {}
+};
+
+/**
+ * @class KpiTimeSeries
+ * @brief Buckets completions and utilization into fixed simulated-time windows
+ *
+ * Only the currently open window is held in memory; each closed window is
+ * written as one CSV row immediately. Events that arrive for a window that
+ * has already been written are counted in the open window.
+ */
+class KpiTimeSeries {
+public:
+    typedef std::function<void(KpiSample&)> Sampler;
+
+    KpiTimeSeries();
+    ~KpiTimeSeries();
+
+    bool open(const std::string& filename, int window_minutes, int start_minutes,
+              const std::vector<std::string>& tracked_skus);
+    void set_sampler(const Sampler& fn) { sampler = fn; }
+    bool is_open() const { return enabled; }
+
+    void advance_to(int minutes);
+    void record_completion(int minutes);
+    void record_station_busy(int start_minutes, int end_minutes);
+    void finish(int end_minutes);
+
+private:
+    std::ofstream file;
+    mutable std::mutex series_mutex;
+    Sampler sampler;
+    bool enabled;
+
+    int window_minutes;
+    int window_start;
+    size_t num_tracked_skus;
+
+    // Open-window accumulators
+    int completions;
+    long long last_agv_busy_total;
+    std::deque<std::pair<int, int> > busy_intervals;  // Station busy [start, end), not yet fully consumed
+
+    void advance_locked(int minutes);
+    void flush_window();
+};
+/*************************************************************************************/
+#endif /* KPI_TIME_SERIES_H */
@@ -0,0 +1,182 @@
+/**
+ * @file Layout.cpp
+ * @brief Shop-floor layout graph implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "Layout.h"
+#include <queue>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <iostream>
+#include <algorithm>
+/*************************************************************************************/
+
+/****************************Layout Methods******************************************/
+/**
+ * @brief Constructor for Layout (empty graph, 60 m/min default AGV speed)
+ */
+Layout::Layout()
+    : default_speed(60.0),
+      headway(0.1),
+      aisle_total(0),
+      warehouse(-1),
+      station(-1),
+      home(-1),
+      built(false) {
+}
+
+
+/**
+ * @brief Add a node (or return the existing one with that name)
+ * @param name Node name
+ * @return Node index
+ */
+int Layout::add_node(const std::string& name) {
+    auto it = index.find(name);
+    if (it != index.end()) return it->second;
+    int id = (int)names.size();
+    names.push_back(name);
+    index[name] = id;
+    adjacency.emplace_back();
+    built = false;
+    if (name == "WAREHOUSE" && warehouse < 0) warehouse = id;
+    if (name == "STATION" && station < 0) station = id;
+    if (name == "PARK" && home < 0) home = id;
+    return id;
+}
+
+
+/**
+ * @brief Add an aisle segment between two nodes
+ * @param from Start node (created if unknown)
+ * @param to End node (created if unknown)
+ * @param length_m Segment length in meters
+ * @param speed_m_per_min Speed limit (<= 0 uses the default AGV speed)
+ * @param one_way true if the segment can only be driven from -> to
+ * @return false if the length is not positive
+ */
+bool Layout::add_aisle(const std::string& from, const std::string& to,
+                       double length_m, double speed_m_per_min, bool one_way) {
+    if (length_m <= 0.0) return false;
+    int a = add_node(from);
+    int b = add_node(to);
+    double speed = speed_m_per_min > 0.0 ? speed_m_per_min : default_speed;
+    int id = aisle_total++;
+    Aisle forward = { b, id, one_way ? -1 : id + 1, (float)length_m, (float)(length_m / speed) };
+    adjacency[a].push_back(forward);
+    if (!one_way) {
+        Aisle backward = { a, aisle_total++, id, (float)length_m, (float)(length_m / speed) };
+        adjacency[b].push_back(backward);
+    }
+    built = false;
+    return true;
+}
+
+
+/**
+ * @brief Compute the all-pairs travel-time and distance matrices
+ * @param threads Worker threads (0 = hardware concurrency)
+ * @return false if the warehouse or station node is missing or they are not mutually reachable
+ */
+bool Layout::build(int threads) {
+    size_t n = names.size();
+    time_matrix.assign(n * n, std::numeric_limits<float>::infinity());
+    distance_matrix.assign(n * n, std::numeric_limits<float>::infinity());
+
+    int workers = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+    workers = std::max(1, std::min(workers, (int)n));
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        int source;
+        while ((source = next.fetch_add(1)) < (int)n) shortest_paths_from(source);
+    };
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; ++w) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    docks.assign(n, 0);
+    for (int role : { warehouse, station, home }) {
+        if (role >= 0) docks[role] = 1;
+    }
+    for (const auto& s : storage) docks[s.second] = 1;
+
+    built = true;
+    if (warehouse < 0 || station < 0) {
+        std::cerr << "Error: layout needs a WAREHOUSE and a STATION node" << std::endl;
+        return false;
+    }
+    if (!reachable(warehouse, station) || !reachable(station, warehouse)) {
+        std::cerr << "Error: layout WAREHOUSE and STATION are not mutually reachable" << std::endl;
+        return false;
+    }
+    for (const auto& s : storage) {
+        if (!reachable(s.second, station)) {
+            std::cerr << "Warning: storage node " << names[s.second] << " of " << s.first
+                      << " cannot reach the station" << std::endl;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Dijkstra on travel time from one source; fills one matrix row
+ */
+void Layout::shortest_paths_from(int source) {
+    size_t n = names.size();
+    float* time_row = &time_matrix[(size_t)source * n];
+    float* dist_row = &distance_matrix[(size_t)source * n];
+
+    typedef std::pair<float, int> Entry;  // (time, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > frontier;
+    time_row[source] = 0.0f;
+    dist_row[source] = 0.0f;
+    frontier.push(Entry(0.0f, source));
+
+    while (!frontier.empty()) {
+        Entry top = frontier.top();
+        frontier.pop();
+        int u = top.second;
+        if (top.first > time_row[u]) continue;
+        for (const auto& aisle : adjacency[u]) {
+            float t = time_row[u] + aisle.time_minutes;
+            if (t < time_row[aisle.to]) {
+                time_row[aisle.to] = t;
+                dist_row[aisle.to] = dist_row[u] + aisle.length_m;
+                frontier.push(Entry(t, aisle.to));
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Look up a node by name
+ * @return Node index, or -1 if unknown
+ */
+int Layout::find_node(const std::string& name) const {
+    auto it = index.find(name);
+    return it != index.end() ? it->second : -1;
+}
+
+
+/**
+ * @brief Whether a path exists from one node to another
+ */
+bool Layout::reachable(int from, int to) const {
+    return built && from >= 0 && to >= 0 &&
+           travel_time(from, to) != std::numeric_limits<float>::infinity();
+}
+
+
+/**
+ * @brief Node where an item is stored (the warehouse node unless mapped)
+ */
+int Layout::storage_node(const std::string& item_id) const {
+    auto it = storage.find(item_id);
+    return it != storage.end() ? it->second : warehouse;
+}
+/*************************************************************************************/
@@ -0,0 +1,91 @@
+/**
+ * @file Layout.h
+ * @brief Shop-floor layout graph with precomputed all-pairs AGV travel times
+ */
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+/*************************************************************************************/
+
+/****************************Layout Class Definition**********************************/
+/**
+ * @class Layout
+ * @brief Nodes joined by aisles (length, speed limit, optional one-way)
+ *
+ * build() runs Dijkstra from every node in parallel and stores the fastest
+ * travel time and its path length for every (from, to) pair in flat
+ * row-major matrices, so per-leg lookups during the simulation are O(1).
+ * Nodes named WAREHOUSE, STATION and PARK take those roles unless the
+ * layout file assigns them explicitly.
+ */
+class Layout {
+public:
+    Layout();
+
+    // Construction (before build)
+    int add_node(const std::string& name);
+    bool add_aisle(const std::string& from, const std::string& to,
+                   double length_m, double speed_m_per_min, bool one_way);
+    void set_default_speed(double m_per_min) { default_speed = m_per_min; }
+    void set_storage(const std::string& item_id, const std::string& node) { storage[item_id] = add_node(node); }
+    void set_warehouse_node(const std::string& node) { warehouse = add_node(node); }
+    void set_station_node(const std::string& node) { station = add_node(node); }
+    void set_home_node(const std::string& node) { home = add_node(node); }
+    void set_headway(double minutes) { headway = minutes; }
+    bool build(int threads = 0);
+
+    // Queries (after build)
+    bool is_built() const { return built; }
+    int node_count() const { return (int)names.size(); }
+    int find_node(const std::string& name) const;
+    const std::string& node_name(int node) const { return names[node]; }
+
+    double travel_time(int from, int to) const { return time_matrix[(size_t)from * names.size() + to]; }
+    double distance(int from, int to) const { return distance_matrix[(size_t)from * names.size() + to]; }
+    bool reachable(int from, int to) const;
+
+    int warehouse_node() const { return warehouse; }
+    int station_node() const { return station; }
+    int home_node() const { return home >= 0 ? home : warehouse; }
+    int storage_node(const std::string& item_id) const;
+
+    // Graph access for routing
+    struct Aisle {
+        int to;
+        int id;                            // Directed segment index, 0..aisle_count()-1
+        int reverse;                       // Opposite direction of a two-way aisle, -1 if one-way
+        float length_m;
+        float time_minutes;
+    };
+    const std::vector<Aisle>& aisles_from(int node) const { return adjacency[node]; }
+    int aisle_count() const { return aisle_total; }
+    bool is_dock(int node) const { return docks[node] != 0; }   // Role or storage node (many bays)
+    double headway_minutes() const { return headway; }
+
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> index;
+    std::vector<std::vector<Aisle> > adjacency;
+    std::map<std::string, int> storage;    // item_id -> node
+    double default_speed;                  // m/min when an aisle has no limit
+    double headway;                        // Minimum time gap between AGVs at a junction or aisle entry
+    int aisle_total;
+    std::vector<char> docks;
+    int warehouse;
+    int station;
+    int home;
+    bool built;
+
+    std::vector<float> time_matrix;        // minutes, row-major [from][to]
+    std::vector<float> distance_matrix;    // meters along the fastest path
+
+    void shortest_paths_from(int source);
+};
+/*************************************************************************************/
+#endif /* LAYOUT_H */
@@ -0,0 +1,67 @@
+/**
+ * @file LotBatcher.cpp
+ * @brief Lot batching implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "LotBatcher.h"
+#include <algorithm>
+/*************************************************************************************/
+
+/****************************LotBatcher Methods**************************************/
+/**
+ * @brief Add a released order to its product's open lot (opening one if needed)
+ * @param product_id Product of the order
+ * @param member Order reference stored in the lot
+ * @param now Release time
+ * @param full Set to the closed lot when this order fills it
+ * @param limit Size cap of this product, applied with the batcher's own (0: none)
+ * @return true if the lot reached the size cap and was closed
+ */
+bool LotBatcher::add(const std::string& product_id, int member, double now, Lot& full, int limit) {
+    auto it = open.find(product_id);
+    if (it == open.end()) {
+        it = open.emplace(product_id, Lot()).first;
+        it->second.product_id = product_id;
+        it->second.opened_minutes = now;
+    }
+    it->second.members.push_back(member);
+    if (max_orders > 0 && (limit <= 0 || max_orders < limit)) limit = max_orders;
+    if (limit <= 0 || (int)it->second.members.size() < limit) return false;
+    full = it->second;
+    open.erase(it);
+    return true;
+}
+
+
+/**
+ * @brief Close every lot whose window has ended by `now`
+ * @param closed Receives the lots, oldest first
+ */
+void LotBatcher::close_expired(double now, std::vector<Lot>& closed) {
+    size_t first = closed.size();
+    for (auto it = open.begin(); it != open.end();) {
+        if (it->second.opened_minutes + window_minutes <= now) {
+            closed.push_back(it->second);
+            it = open.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::stable_sort(closed.begin() + first, closed.end(),
+                     [](const Lot& a, const Lot& b) { return a.opened_minutes < b.opened_minutes; });
+}
+
+
+/**
+ * @brief Close every open lot (end of the order book)
+ * @param closed Receives the lots, oldest first
+ */
+void LotBatcher::close_all(std::vector<Lot>& closed) {
+    size_t first = closed.size();
+    for (auto& entry : open) closed.push_back(entry.second);
+    open.clear();
+    std::stable_sort(closed.begin() + first, closed.end(),
+                     [](const Lot& a, const Lot& b) { return a.opened_minutes < b.opened_minutes; });
+}
+/*************************************************************************************/
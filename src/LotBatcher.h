@@ -0,0 +1,62 @@
+/**
+ * @file LotBatcher.h
+ * @brief Merges released orders of the same product into production lots
+ */
+
+#ifndef LOT_BATCHER_H
+#define LOT_BATCHER_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+/*************************************************************************************/
+
+/*****************************Lot Structure Definition*********************************/
+/**
+ * @struct Lot
+ * @brief Orders of one product that are reserved, moved and assembled together
+ */
+struct Lot {
+    std::string product_id;
+    std::vector<int> members;            // Order references in release order (caller-defined)
+    double opened_minutes;               // Release time of the first member
+
+    Lot() : opened_minutes(0.0) {}
+};
+/*************************************************************************************/
+
+/****************************LotBatcher Class Definition******************************/
+/**
+ * @class LotBatcher
+ * @brief One open lot per product, closed when full or when its window ends
+ *
+ * The caller adds each released order and closes a lot when add() reports
+ * the size cap (or the product's own limit, such as what one AGV can
+ * carry), or when close_expired() is called at or after the lot's deadline
+ * (opened + window). close_all() flushes the rest at the end of the order
+ * book. The batcher keeps no clock of its own, so the threaded scheduler
+ * and the event-driven model drive it with their own time.
+ */
+class LotBatcher {
+public:
+    LotBatcher() : window_minutes(0.0), max_orders(0) {}
+
+    void configure(double window, int max_size) { window_minutes = window; max_orders = max_size; }
+    bool enabled() const { return window_minutes > 0.0; }
+    double window() const { return window_minutes; }
+    int max_size() const { return max_orders; }
+
+    bool add(const std::string& product_id, int member, double now, Lot& full, int limit = 0);
+    void close_expired(double now, std::vector<Lot>& closed);
+    void close_all(std::vector<Lot>& closed);
+    bool has_open(const std::string& product_id) const { return open.count(product_id) != 0; }
+    bool empty() const { return open.empty(); }
+
+private:
+    double window_minutes;               // > 0 enables batching
+    int max_orders;                      // Size cap (0: window only)
+    std::map<std::string, Lot> open;     // Product -> its open lot
+};
+/*************************************************************************************/
+#endif /* LOT_BATCHER_H */
@@ -0,0 +1,195 @@
+/**
+ * @file MaterialPlanner.cpp
+ * @brief MRP pass implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "MaterialPlanner.h"
+#include <unordered_map>
+#include <thread>
+#include <chrono>
+#include <numeric>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+/*************************************************************************************/
+
+namespace {
+const int UNKNOWN_PRODUCT = -1;
+const size_t MIN_ORDERS_PER_THREAD = 50000;   // Smaller books are not worth a thread
+
+struct Leaf {
+    int component;                       // Dense component index
+    int quantity;
+};
+
+std::string clock_time(int minutes) {
+    std::stringstream ss;
+    ss << std::setfill('0') << std::setw(2) << minutes / 60 << ":" << std::setw(2) << minutes % 60;
+    return ss.str();
+}
+}
+
+/****************************MaterialPlanner Methods**********************************/
+/**
+ * @brief Constructor for MaterialPlanner
+ * @param orders Order book (lot sizes count as units)
+ * @param products Catalogue with exploded BOMs
+ * @param inventory Initial component stock
+ */
+MaterialPlanner::MaterialPlanner(const std::vector<Order>& orders,
+                                 const std::map<std::string, Product>& products,
+                                 const std::map<std::string, int>& inventory)
+    : orders(orders), products(products), inventory(inventory), threads(0) {
+}
+
+
+/**
+ * @brief Aggregate the demand and forecast the starving orders
+ */
+MaterialPlan MaterialPlanner::plan() const {
+    auto start = std::chrono::steady_clock::now();
+    MaterialPlan result;
+
+    // Dense indices: products in catalogue order, components by ID
+    std::unordered_map<std::string, int> product_index;
+    std::map<std::string, int> component_index;
+    for (const auto& entry : products) {
+        product_index.emplace(entry.first, (int)product_index.size());
+        for (const auto& req : entry.second.leaf_requirements) component_index.emplace(req.component_id, 0);
+    }
+    for (const auto& item : inventory) component_index.emplace(item.first, 0);
+    for (auto& entry : component_index) {
+        entry.second = (int)result.components.size();
+        ComponentBalance balance;
+        balance.component_id = entry.first;
+        auto it = inventory.find(entry.first);
+        balance.stock = it != inventory.end() ? it->second : 0;
+        result.components.push_back(balance);
+    }
+    std::vector<std::vector<Leaf> > leaves;
+    for (const auto& entry : products) {
+        std::vector<Leaf> flat;
+        for (const auto& req : entry.second.leaf_requirements) {
+            Leaf leaf;
+            leaf.component = component_index[req.component_id];
+            leaf.quantity = req.quantity;
+            flat.push_back(leaf);
+        }
+        leaves.push_back(flat);
+    }
+
+    // Parallel reduction: resolve each order's product and count units per product
+    size_t n = orders.size();
+    std::vector<int> product_of(n, UNKNOWN_PRODUCT);
+    size_t workers = threads > 0 ? (size_t)threads : (size_t)std::thread::hardware_concurrency();
+    workers = std::max<size_t>(1, std::min(workers, n / MIN_ORDERS_PER_THREAD));
+    std::vector<std::vector<long long> > units(workers, std::vector<long long>(leaves.size(), 0));
+    auto worker = [&](size_t w) {
+        std::vector<long long>& local = units[w];
+        for (size_t i = n * w / workers; i < n * (w + 1) / workers; ++i) {
+            auto it = product_index.find(orders[i].product_id);
+            if (it == product_index.end()) continue;
+            product_of[i] = it->second;
+            local[it->second] += std::max(orders[i].lot_size, 1);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+
+    for (size_t p = 0; p < leaves.size(); ++p) {
+        long long total = 0;
+        for (size_t w = 0; w < workers; ++w) total += units[w][p];
+        for (const Leaf& leaf : leaves[p]) result.components[leaf.component].demand += total * leaf.quantity;
+    }
+    for (const auto& c : result.components) {
+        if (c.demand > c.stock) result.short_components++;
+    }
+
+    // Project the stock in release order
+    std::vector<size_t> sequence(n);
+    std::iota(sequence.begin(), sequence.end(), 0);
+    std::stable_sort(sequence.begin(), sequence.end(), [this](size_t a, size_t b) {
+        return orders[a].release_time_minutes < orders[b].release_time_minutes;
+    });
+    std::vector<long long> remaining;
+    for (const auto& c : result.components) remaining.push_back(c.stock);
+
+    for (size_t i : sequence) {
+        const Order& order = orders[i];
+        int p = product_of[i];
+        long long lot = std::max(order.lot_size, 1);
+        const Leaf* unbuildable = nullptr;
+        const Leaf* starving = nullptr;
+        if (p != UNKNOWN_PRODUCT) {
+            for (const Leaf& leaf : leaves[p]) {
+                long long need = leaf.quantity * lot;
+                if (need > result.components[leaf.component].stock) { unbuildable = &leaf; break; }
+                if (!starving && need > remaining[leaf.component]) starving = &leaf;
+            }
+            if (!unbuildable && !starving) {
+                for (const Leaf& leaf : leaves[p]) remaining[leaf.component] -= leaf.quantity * lot;
+                continue;
+            }
+        }
+
+        OrderShortage s;
+        s.order_index = (int)i;
+        s.order_id = order.order_id;
+        s.release_minutes = order.release_time_minutes;
+        s.product_id = order.product_id;
+        s.unbuildable = p == UNKNOWN_PRODUCT || unbuildable != nullptr;
+        const Leaf* limit = unbuildable ? unbuildable : starving;
+        if (limit) {
+            ComponentBalance& c = result.components[limit->component];
+            s.component_id = c.component_id;
+            s.required = (int)(limit->quantity * lot);
+            s.available = (int)(unbuildable ? c.stock : remaining[limit->component]);
+            if (c.first_short_order < 0) {
+                c.first_short_order = order.order_id;
+                c.first_short_minutes = order.release_time_minutes;
+            }
+        }
+        if (s.unbuildable) result.unbuildable_orders++;
+        else result.starving_orders++;
+        result.shortages.push_back(s);
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+
+/**
+ * @brief Human-readable MRP report: short components, then every starving order
+ */
+std::string MaterialPlanner::format_report(const MaterialPlan& plan) {
+    std::stringstream ss;
+    ss << "Short components: " << plan.short_components << " of " << plan.components.size() << "\n";
+    ss << "Starving orders: " << plan.starving_orders << " (stock used up by earlier orders)\n";
+    ss << "Unbuildable orders: " << plan.unbuildable_orders << " (skipped before the run)\n\n";
+
+    if (plan.short_components > 0) {
+        ss << std::left << std::setw(14) << "Component" << std::right << std::setw(12) << "Demand"
+           << std::setw(10) << "Stock" << std::setw(12) << "Balance" << "  First short\n";
+        for (const auto& c : plan.components) {
+            if (c.demand <= c.stock) continue;
+            ss << std::left << std::setw(14) << c.component_id << std::right << std::setw(12) << c.demand
+               << std::setw(10) << c.stock << std::setw(12) << c.balance() << "  ";
+            if (c.first_short_order >= 0) ss << "order " << c.first_short_order << " at " << clock_time(c.first_short_minutes);
+            ss << "\n";
+        }
+        ss << "\n";
+    }
+
+    for (const auto& s : plan.shortages) {
+        ss << clock_time(s.release_minutes) << "  order " << s.order_id << " (" << s.product_id << "): ";
+        if (s.component_id.empty()) ss << "no BOM";
+        else ss << s.component_id << " needs " << s.required << ", " << s.available << (s.unbuildable ? " in stock" : " left");
+        ss << (s.unbuildable ? " [unbuildable]" : "") << "\n";
+    }
+    return ss.str();
+}
+/*************************************************************************************/
@@ -0,0 +1,99 @@
+/**
+ * @file MaterialPlanner.h
+ * @brief Pre-run material requirements (MRP) pass and shortage forecast
+ */
+
+#ifndef MATERIAL_PLANNER_H
+#define MATERIAL_PLANNER_H
+
+/******************************Project Headers*****************************************/
+#include "Order.h"
+#include "Product.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+/*************************************************************************************/
+
+/****************************Material Plan Structures*********************************/
+/**
+ * @struct ComponentBalance
+ * @brief Gross demand of one component over the order book against its stock
+ */
+struct ComponentBalance {
+    std::string component_id;
+    long long demand;                    // Units needed by all orders
+    int stock;                           // Initial warehouse stock
+    int first_short_order;               // ID of the first order it starves (-1: stock suffices)
+    int first_short_minutes;             // That order's release time
+
+    ComponentBalance() : demand(0), stock(0), first_short_order(-1), first_short_minutes(-1) {}
+    long long balance() const { return stock - demand; }
+};
+
+/**
+ * @struct OrderShortage
+ * @brief An order that will find a component short when it is released
+ */
+struct OrderShortage {
+    int order_index;                     // Index into the order book
+    int order_id;
+    int release_minutes;
+    std::string product_id;
+    std::string component_id;            // First short component (empty: product has no BOM)
+    int required;                        // Units of it the order needs
+    int available;                       // Projected stock at release
+    bool unbuildable;                    // Not even the full initial stock covers it
+
+    OrderShortage() : order_index(-1), order_id(-1), release_minutes(0), required(0), available(0), unbuildable(false) {}
+};
+
+/**
+ * @struct MaterialPlan
+ * @brief Result of the MRP pass
+ */
+struct MaterialPlan {
+    std::vector<ComponentBalance> components;   // By component ID
+    std::vector<OrderShortage> shortages;       // In release order
+    int starving_orders;                 // Buildable alone, but stock runs out before them
+    int unbuildable_orders;
+    int short_components;                // Components with demand above stock
+    double seconds;                      // Wall-clock time of the pass
+
+    MaterialPlan() : starving_orders(0), unbuildable_orders(0), short_components(0), seconds(0.0) {}
+};
+/*************************************************************************************/
+
+/****************************MaterialPlanner Class Definition*************************/
+/**
+ * @class MaterialPlanner
+ * @brief Nets the exploded demand of the order book against the warehouse stock
+ *
+ * The pass resolves every order's product and sums the demand in
+ * parallel (per-thread product histograms, reduced and multiplied by the
+ * cached leaf requirements). It then projects the stock in release order:
+ * an order whose components are all still available consumes them, and
+ * any other order starves at its release time without consuming. This is
+ * what FIFO reservation without replenishment would do; other policies may
+ * reorder which of the orders competing for a short component starve.
+ */
+class MaterialPlanner {
+public:
+    MaterialPlanner(const std::vector<Order>& orders,
+                    const std::map<std::string, Product>& products,
+                    const std::map<std::string, int>& inventory);
+
+    void set_threads(int n) { threads = n; }
+    MaterialPlan plan() const;
+    static std::string format_report(const MaterialPlan& plan);
+
+private:
+    const std::vector<Order>& orders;
+    const std::map<std::string, Product>& products;
+    const std::map<std::string, int>& inventory;
+    int threads;                         // 0: all cores
+};
+/*************************************************************************************/
+#endif /* MATERIAL_PLANNER_H */
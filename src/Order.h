@@ -24,10 +24,12 @@ struct Order {
     int completion_time_minutes;
     bool is_completed;         // Flag indicating if order is completed
     bool is_canceled;          // Flag indicating if order was canceled (e.g., shortage)
+    bool is_unbuildable;       // Canceled before the run: the initial stock can never cover it (MRP)
+    int lot_size;              // Orders assembled with this one as a lot (1: not batched)
     
     Order() : order_id(0), release_hour(0), release_minute(0), release_time_minutes(0),
               priority(0), due_date_minutes(-1), completion_time_minutes(-1),
-              is_completed(false), is_canceled(false) {} 
+              is_completed(false), is_canceled(false), is_unbuildable(false), lot_size(1) {} 
 };
 /*************************************************************************************/
 #endif /* ORDER_H */
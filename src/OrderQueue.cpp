@@ -0,0 +1,184 @@
+/**
+ * @file OrderQueue.cpp
+ * @brief Station order queue implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "OrderQueue.h"
+#include <thread>
+/*************************************************************************************/
+
+namespace {
+// Yielding attempts before a consumer sleeps on an empty queue
+const int SPIN_TRIES = 16;
+}
+
+/****************************OrderQueue Methods**************************************/
+/**
+ * @brief Constructor for OrderQueue
+ * @param capacity Order slots (rounded up to a power of two)
+ */
+OrderQueue::OrderQueue(size_t capacity)
+    : ready(capacity),
+      free_slots(capacity),
+      waiting(0),
+      peak_depth(0),
+      pushed(0),
+      full_waits(0),
+      closed(false) {
+    slots.resize(free_slots.capacity());
+    for (size_t i = 0; i < slots.size(); ++i) free_slots.try_push((OrderHandle)i);
+}
+
+
+/**
+ * @brief Copy an order into a free slot and queue its handle
+ * @return false if every slot is in use
+ */
+bool OrderQueue::try_push(const Order& order) {
+    OrderHandle handle;
+    if (!free_slots.try_pop(handle)) return false;
+    slots[handle] = order;
+    pushed.fetch_add(1, std::memory_order_relaxed);
+    publish(handle);
+    return true;
+}
+
+
+/**
+ * @brief Queue an order, waiting for a free slot while the queue is full
+ * @return false if the queue was closed before a slot became free
+ */
+bool OrderQueue::push(const Order& order) {
+    if (try_push(order)) return true;
+    full_waits.fetch_add(1, std::memory_order_relaxed);
+    return sleep(not_full, [this, &order] { return try_push(order); });
+}
+
+
+/**
+ * @brief Take the oldest order's handle without waiting
+ * @return false if the queue is empty
+ */
+bool OrderQueue::try_pop(OrderHandle& handle) {
+    if (!ready.try_pop(handle)) return false;
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+
+/**
+ * @brief Take the oldest order's handle, sleeping while the queue is empty
+ * @return false once the queue is closed and empty
+ */
+bool OrderQueue::pop_wait(OrderHandle& handle) {
+    for (int spin = 0; spin < SPIN_TRIES; ++spin) {
+        if (try_pop(handle)) return true;
+        std::this_thread::yield();
+    }
+    return sleep(not_empty, [this, &handle] { return try_pop(handle); });
+}
+
+
+/**
+ * @brief Put a popped handle back at the tail (the order keeps its slot)
+ */
+void OrderQueue::requeue(OrderHandle handle) {
+    publish(handle);
+}
+
+
+/**
+ * @brief Return a popped order's slot once the consumer is done with it
+ */
+void OrderQueue::release(OrderHandle handle) {
+    ring_push(free_slots, handle);
+    wake(not_full);
+}
+
+
+/**
+ * @brief Accept blocking calls again after close()
+ */
+void OrderQueue::open() {
+    closed.store(false);
+}
+
+
+/**
+ * @brief Wake every blocked push and pop; they return false instead of sleeping again
+ */
+void OrderQueue::close() {
+    closed.store(true);
+    for (Sleepers* s : {&not_empty, &not_full}) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->cv.notify_all();
+    }
+}
+
+
+OrderQueueStats OrderQueue::stats() const {
+    OrderQueueStats s;
+    s.pushed = pushed.load();
+    s.depth = waiting.load();
+    s.peak_depth = peak_depth.load();
+    s.full_waits = full_waits.load();
+    return s;
+}
+
+
+void OrderQueue::publish(OrderHandle handle) {
+    // Count before the handle becomes visible, so a consumer never drives the depth below zero
+    int depth = waiting.fetch_add(1, std::memory_order_relaxed) + 1;
+    int peak = peak_depth.load(std::memory_order_relaxed);
+    while (depth > peak && !peak_depth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {}
+    ring_push(ready, handle);
+    wake(not_empty);
+}
+
+
+/**
+ * @brief Push a handle into a ring that has a cell for every slot
+ *
+ * The ring can still look full for a moment while a consumer that claimed
+ * the oldest cell has not yet marked it free; retry until it has.
+ */
+void OrderQueue::ring_push(BoundedMpmcQueue<OrderHandle>& ring, OrderHandle handle) {
+    while (!ring.try_push(handle)) std::this_thread::yield();
+}
+
+
+/**
+ * @brief Sleep until an attempt succeeds or the queue is closed
+ * @return true if the attempt succeeded
+ */
+template <typename Attempt>
+bool OrderQueue::sleep(Sleepers& sleepers, Attempt attempt) {
+    std::unique_lock<std::mutex> lock(sleepers.mutex);
+    sleepers.count.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool done = false;
+    for (;;) {
+        if (attempt()) { done = true; break; }
+        if (closed.load()) break;
+        sleepers.cv.wait(lock);
+    }
+    sleepers.count.fetch_sub(1, std::memory_order_relaxed);
+    return done;
+}
+
+
+/**
+ * @brief Wake one sleeper, if any (one item or one slot was added)
+ *
+ * The fence pairs with the one in sleep(): either the sleeper sees the
+ * new item on its re-check or this load sees the sleeper, so no wakeup is
+ * lost.
+ */
+void OrderQueue::wake(Sleepers& sleepers) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.count.load(std::memory_order_relaxed) == 0) return;
+    std::lock_guard<std::mutex> lock(sleepers.mutex);
+    sleepers.cv.notify_one();
+}
+/*************************************************************************************/
@@ -0,0 +1,107 @@
+/**
+ * @file OrderQueue.h
+ * @brief Station order queue: preallocated order slots passed around as compact handles
+ */
+
+#ifndef ORDER_QUEUE_H
+#define ORDER_QUEUE_H
+
+/******************************Project Headers*****************************************/
+#include "Order.h"
+#include "BoundedMpmcQueue.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+/*************************************************************************************/
+
+typedef uint32_t OrderHandle;   // Index of an order slot
+
+/*****************************OrderQueueStats Structure Definition*********************/
+/**
+ * @struct OrderQueueStats
+ * @brief Queue-depth telemetry
+ */
+struct OrderQueueStats {
+    long long pushed;            // Orders added (requeues not counted)
+    int depth;                   // Orders waiting now
+    int peak_depth;              // Highest depth seen
+    long long full_waits;        // Blocking pushes that found every slot in use
+
+    OrderQueueStats() : pushed(0), depth(0), peak_depth(0), full_waits(0) {}
+};
+/*************************************************************************************/
+
+/****************************OrderQueue Class Definition*****************************/
+/**
+ * @class OrderQueue
+ * @brief Bounded MPMC FIFO of orders with blocking and non-blocking push/pop
+ *
+ * Orders are copied once into a preallocated slot; producers and consumers
+ * then exchange only the slot's 32-bit handle through two lock-free rings
+ * (ready handles and free slots). A consumer reads the order in place with
+ * get() and hands the slot back with release() when it is done with it, or
+ * puts the handle back with requeue() to retry later.
+ *
+ * The fast paths take no lock. The blocking variants sleep on a condition
+ * variable only when the queue stays empty for a few yields (pop_wait) or
+ * is full (push), and the other side signals only if somebody is asleep.
+ */
+class OrderQueue {
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    explicit OrderQueue(size_t capacity = DEFAULT_CAPACITY);
+
+    bool try_push(const Order& order);
+    bool push(const Order& order);
+    bool try_pop(OrderHandle& handle);
+    bool pop_wait(OrderHandle& handle);
+    void requeue(OrderHandle handle);
+    void release(OrderHandle handle);
+    const Order& get(OrderHandle handle) const { return slots[handle]; }
+
+    void open();
+    void close();
+
+    int depth() const { return waiting.load(std::memory_order_relaxed); }
+    bool empty() const { return depth() == 0; }
+    size_t capacity() const { return slots.size(); }
+    OrderQueueStats stats() const;
+
+private:
+    /**
+     * @struct Sleepers
+     * @brief Condition variable that producers or consumers signal only when someone waits on it
+     */
+    struct Sleepers {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<int> count;
+
+        Sleepers() : count(0) {}
+    };
+
+    std::vector<Order> slots;
+    BoundedMpmcQueue<OrderHandle> ready;        // Handles of queued orders, FIFO
+    BoundedMpmcQueue<OrderHandle> free_slots;   // Unused slots
+    std::atomic<int> waiting;                   // Depth (ready handles)
+    std::atomic<int> peak_depth;
+    std::atomic<long long> pushed;
+    std::atomic<long long> full_waits;
+    std::atomic<bool> closed;
+    Sleepers not_empty;                         // Consumers in pop_wait
+    Sleepers not_full;                          // Producers in push
+
+    void publish(OrderHandle handle);
+    static void ring_push(BoundedMpmcQueue<OrderHandle>& ring, OrderHandle handle);
+    template <typename Attempt>
+    bool sleep(Sleepers& sleepers, Attempt attempt);
+    static void wake(Sleepers& sleepers);
+};
+/*************************************************************************************/
+#endif /* ORDER_QUEUE_H */
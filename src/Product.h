@@ -1,6 +1,6 @@
 /**
  * @file Product.h
- * @brief Product and Bill of Materials (BOM) definitions
+ * @brief Product, Bill of Materials (BOM) and routing definitions
  */
 
 #ifndef PRODUCT_H
@@ -24,16 +24,61 @@ struct ComponentRequirement {
         : component_id(id), quantity(qty) {}
 };
 
+/**
+ * @struct Operation
+ * @brief One routing step: a process time on any one of its eligible workcenters
+ */
+struct Operation {
+    std::string name;
+    int process_minutes;                    // Per unit
+    std::vector<std::string> workcenters;   // Eligible workcenters
+
+    Operation() : process_minutes(0) {}
+};
+
+/**
+ * @struct Workcenter
+ * @brief A group of identical machines that performs routing operations
+ *
+ * The input buffer holds jobs queued for a machine (and space reserved by
+ * jobs on their way); the output buffer holds finished jobs until an AGV
+ * picks them up. A job that finishes while the output buffer is full
+ * keeps its machine blocked (blocking after service).
+ */
+struct Workcenter {
+    std::string name;
+    int machines;                           // Operations in progress at once
+    std::string node;                       // Layout node (empty: the workcenter's name, else the station)
+    int input_buffer;                       // Jobs queued or inbound (-1: unlimited)
+    int output_buffer;                      // Finished jobs waiting for pickup (-1: unlimited)
+
+    Workcenter() : machines(1), input_buffer(-1), output_buffer(-1) {}
+};
+
 /**
  * @struct Product
- * @brief Represents a product with its BOM and base assembly time
+ * @brief Represents a product with its BOM, base assembly time and routing
+ *
+ * Components are kitted and assembled at the assembly station (T_base);
+ * the routing lists the operations that follow, in order. AGVs move the
+ * work in process between workcenters.
+ *
+ * BOM entries may name other products (subassemblies built in the cell
+ * as part of the order). BomExplosion flattens them once at load time
+ * into leaf_requirements and total_assembly_minutes, which is all the
+ * station and the warehouse look at.
  */
 struct Product {
     std::string product_id;
-    int base_assembly_time_minutes;  // T_base in minutes
-    std::map<std::string, int> bom;  // component_id -> quantity
+    int base_assembly_time_minutes;  // T_base in minutes (this level only)
+    std::map<std::string, int> bom;  // component or subassembly id -> quantity
+    std::vector<Operation> routing;  // Operations after assembly (empty: assembly only)
+
+    // Explosion cache
+    std::vector<ComponentRequirement> leaf_requirements;   // Components per unit over all levels, by ID
+    int total_assembly_minutes;      // T_base plus the subassemblies built for one unit
     
-    Product() : base_assembly_time_minutes(0) {}
+    Product() : base_assembly_time_minutes(0), total_assembly_minutes(0) {}
 };
 /*************************************************************************************/
 #endif /* PRODUCT_H */
@@ -0,0 +1,251 @@
+/**
+ * @file QueueingEstimator.cpp
+ * @brief Analytical KPI estimate implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "QueueingEstimator.h"
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+/*************************************************************************************/
+
+namespace {
+const int FIXED_POINT_ITERATIONS = 100;
+const double FIXED_POINT_TOLERANCE = 1e-6;   // Minutes of AGV wait
+
+/**
+ * @brief Squared coefficient of variation from the first two moments
+ */
+double scv(double mean, double second) {
+    return mean > 0.0 ? std::max(0.0, second / (mean * mean) - 1.0) : 0.0;
+}
+
+/**
+ * @brief Average wait of a saturated queue: order k waits k * (E[S] / c - 1 / lambda)
+ */
+double backlog_wait(int customers, int servers, double arrival_rate, double mean_service) {
+    double gap = arrival_rate > 0.0 && std::isfinite(arrival_rate) ? 1.0 / arrival_rate : 0.0;
+    return std::max(0.0, (customers - 1) / 2.0 * (mean_service / servers - gap));
+}
+}
+
+/****************************QueueingEstimator Methods********************************/
+/**
+ * @brief Constructor for QueueingEstimator
+ * @param config Run configuration (AGVs, slots, process times, layout, setups)
+ */
+QueueingEstimator::QueueingEstimator(const SimulationConfig& config) : config(config) {
+}
+
+
+/**
+ * @brief Erlang C: probability that an arrival waits in an M/M/c queue
+ * @param servers c
+ * @param offered_load a = lambda E[S] (must be below c)
+ */
+double QueueingEstimator::erlang_c(int servers, double offered_load) {
+    if (offered_load <= 0.0) return 0.0;
+    double rho = offered_load / servers;
+    if (rho >= 1.0) return 1.0;
+
+    // Erlang B by the stable recursion, then C = B / (1 - rho (1 - B))
+    double b = 1.0;
+    for (int k = 1; k <= servers; ++k) b = offered_load * b / (k + offered_load * b);
+    return b / (1.0 - rho * (1.0 - b));
+}
+
+
+/**
+ * @brief Mean queue wait of an M/G/c queue
+ * @param servers c (1 gives the exact Pollaczek-Khinchine M/G/1 wait)
+ * @param arrival_rate lambda
+ * @param mean_service E[S]
+ * @param service_scv Squared coefficient of variation of S
+ * @return Minutes, or infinity at rho >= 1
+ *
+ * Allen-Cunneen: the M/M/c wait scaled by (1 + cs^2) / 2.
+ */
+double QueueingEstimator::mgc_wait(int servers, double arrival_rate, double mean_service, double service_scv) {
+    double offered = arrival_rate * mean_service;
+    if (offered <= 0.0) return 0.0;
+    if (offered >= servers) return std::numeric_limits<double>::infinity();
+    double mmc_wait = erlang_c(servers, offered) * mean_service / (servers - offered);
+    return mmc_wait * (1.0 + service_scv) / 2.0;
+}
+
+
+/**
+ * @brief Mean speed factor of the fleet (1 without vehicle types)
+ */
+double QueueingEstimator::average_speed() const {
+    if (!config.fleet || config.fleet->fleet_size() == 0) return 1.0;
+    double sum = 0.0;
+    for (int k = 0; k < config.fleet->fleet_size(); ++k) {
+        sum += config.fleet->get_type(config.fleet->type_of_slot(k)).speed_factor;
+    }
+    return sum / config.fleet->fleet_size();
+}
+
+
+/**
+ * @brief Duration of one transport task (empty leg, pick, loaded leg, drop)
+ *
+ * With a layout the AGV is taken to start at the station, where its last
+ * delivery usually ended; travel variation scales the matrix time.
+ */
+QueueingEstimator::Moments QueueingEstimator::trip_moments(const std::string& item_id, bool is_finished_product,
+                                                            double speed) const {
+    const ProcessTimeModel& p = config.process_times;
+    Moments trip;
+    double empty = p.travel_warehouse.mean() / speed;
+    double loaded = p.travel_station.mean() / speed;
+    double empty_var = p.travel_warehouse.variance() / (speed * speed);
+    double loaded_var = p.travel_station.variance() / (speed * speed);
+    if (config.layout) {
+        int storage = config.layout->storage_node(item_id);
+        int station = config.layout->station_node();
+        int pickup = is_finished_product ? station : storage;
+        int dropoff = is_finished_product ? storage : station;
+        empty = config.layout->travel_time(station, pickup) / speed;
+        loaded = config.layout->travel_time(pickup, dropoff) / speed;
+        double m = p.travel_warehouse.mean();
+        empty_var = m > 0.0 ? empty * empty * p.travel_warehouse.variance() / (m * m) : 0.0;
+        m = p.travel_station.mean();
+        loaded_var = m > 0.0 ? loaded * loaded * p.travel_station.variance() / (m * m) : 0.0;
+    }
+    trip.add(empty, empty_var);
+    trip.add(p.picking.mean(), p.picking.variance());
+    trip.add(loaded, loaded_var);
+    trip.add(p.dropping.mean(), p.dropping.variance());
+    return trip;
+}
+
+
+/**
+ * @brief Expected changeover per order when consecutive products are independent draws from the mix
+ */
+double QueueingEstimator::expected_setup(const std::map<std::string, int>& product_mix, int orders) const {
+    if (!config.setups || orders == 0) return config.setup_time_minutes;
+    double expected = 0.0;
+    for (const auto& from : product_mix) {
+        for (const auto& to : product_mix) {
+            expected += (double)from.second * to.second * config.setups->setup_minutes(from.first, to.first);
+        }
+    }
+    return expected / ((double)orders * orders);
+}
+
+
+/**
+ * @brief Estimate the KPIs of the order book
+ * @param orders Order book (canceled and unknown-product orders are ignored)
+ * @param products Catalogue with exploded BOMs
+ */
+QueueingEstimate QueueingEstimator::estimate(const std::vector<Order>& orders,
+                                             const std::map<std::string, Product>& products) const {
+    auto start = std::chrono::steady_clock::now();
+    QueueingEstimate e;
+
+    // Order mix and arrival rate
+    std::map<std::string, int> mix;
+    double first_release = std::numeric_limits<double>::max();
+    double last_release = 0.0;
+    for (const auto& order : orders) {
+        if (order.is_canceled || !products.count(order.product_id)) continue;
+        mix[order.product_id]++;
+        first_release = std::min(first_release, (double)order.release_time_minutes);
+        last_release = std::max(last_release, (double)order.release_time_minutes);
+    }
+    for (const auto& entry : mix) e.orders += entry.second;
+    if (e.orders == 0) return e;
+    double span = last_release - first_release;
+    e.arrival_rate = span > 0.0 ? (e.orders - 1) / span : std::numeric_limits<double>::infinity();
+
+    // Per product: AGV trips (one per leaf unit, plus the finished-product return),
+    // the delivery of its components and T_op (calculate_operation_time for one unit)
+    double speed = average_speed();
+    int agvs = std::max(1, config.num_agvs);
+    int slots = std::max(1, config.station_slots);
+    const Distribution& factor = config.process_times.assembly_factor;
+    double f_mean = factor.mean();
+    double f_second = factor.variance() + f_mean * f_mean;
+    double setup = expected_setup(mix, e.orders);
+    struct Line { double weight; double delivery; double nominal; bool kitted; };
+    std::vector<Line> lines;
+    Moments all_trips;
+    double tasks = 0.0;
+    double assembly_minutes = 0.0;
+    for (const auto& entry : mix) {
+        const Product& product = products.at(entry.first);
+        Line line;
+        line.weight = entry.second;
+        line.nominal = product.total_assembly_minutes + setup;
+        line.kitted = !product.leaf_requirements.empty();
+        double slowest = 0.0;
+        double work = 0.0;
+        int units = 0;
+        for (const auto& req : product.leaf_requirements) {
+            Moments trip = trip_moments(req.component_id, false, speed);
+            all_trips.mean += line.weight * req.quantity * trip.mean;
+            all_trips.second += line.weight * req.quantity * trip.second;
+            slowest = std::max(slowest, trip.mean);
+            work += req.quantity * trip.mean;
+            units += req.quantity;
+        }
+        // The order's trips leave together: the slowest one, or the fleet's share of the burst
+        line.delivery = std::max(slowest, work / agvs);
+        Moments back = trip_moments(entry.first, true, speed);
+        all_trips.mean += line.weight * back.mean;
+        all_trips.second += line.weight * back.second;
+        tasks += line.weight * (units + 1);
+        assembly_minutes += line.weight * line.nominal * f_mean;
+        lines.push_back(line);
+    }
+    e.trips_per_order = tasks / e.orders;
+    e.trip_minutes = all_trips.mean / tasks;
+    double trip_scv = scv(e.trip_minutes, all_trips.second / tasks);
+
+    // A slot is held for the AGV wait, the delivery and T_op; the AGVs see
+    // orders only as fast as the station starts them. Iterate the two queues
+    // to a fixed point (the AGV wait grows with the order rate it allows).
+    double fleet_rate = agvs / (e.trips_per_order * e.trip_minutes);   // Orders per minute the fleet can carry
+    double order_rate = 0.0;
+    Moments slot;
+    for (int iteration = 0; iteration < FIXED_POINT_ITERATIONS; ++iteration) {
+        slot = Moments();
+        for (const Line& line : lines) {
+            double hold = line.kitted ? e.agv_wait_minutes + line.delivery : 0.0;
+            slot.mean += line.weight * (hold + line.nominal * f_mean);
+            slot.second += line.weight * (hold * hold + 2.0 * hold * line.nominal * f_mean + line.nominal * line.nominal * f_second);
+        }
+        e.station_service_minutes = slot.mean / e.orders;
+        order_rate = std::min(e.arrival_rate, std::min(slots / e.station_service_minutes, fleet_rate));
+        e.agv_load = order_rate / fleet_rate;
+        double wait = e.agv_load < 1.0 ? mgc_wait(agvs, order_rate * e.trips_per_order, e.trip_minutes, trip_scv) : 0.0;
+        if (std::fabs(wait - e.agv_wait_minutes) < FIXED_POINT_TOLERANCE) break;
+        e.agv_wait_minutes = (e.agv_wait_minutes + wait) / 2.0;   // Damped: the wait feeds back on the rate
+    }
+    e.station_service_scv = scv(e.station_service_minutes, slot.second / e.orders);
+    e.station_load = std::isfinite(e.arrival_rate) ? e.arrival_rate * e.station_service_minutes / slots
+                                                   : std::numeric_limits<double>::infinity();
+    double capacity = std::min(slots / e.station_service_minutes, fleet_rate);
+    if (e.arrival_rate < capacity) {
+        e.station_wait_minutes = mgc_wait(slots, e.arrival_rate, e.station_service_minutes, e.station_service_scv);
+    } else {
+        e.saturated = true;
+        e.station_wait_minutes = backlog_wait(e.orders, 1, e.arrival_rate, 1.0 / capacity);
+    }
+
+    // KPIs with the simulator's definitions: busy time over the makespan
+    e.avg_lead_time = e.station_wait_minutes + e.station_service_minutes;
+    e.makespan_minutes = std::max(span + e.avg_lead_time, e.orders / capacity);
+    e.throughput = e.orders * 60.0 / e.makespan_minutes;
+    e.station_utilization = assembly_minutes / (slots * e.makespan_minutes);
+    e.agv_utilization = all_trips.mean / (agvs * e.makespan_minutes);
+
+    e.microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return e;
+}
+/*************************************************************************************/
@@ -0,0 +1,104 @@
+/**
+ * @file QueueingEstimator.h
+ * @brief Analytical KPI estimate of the assembly cell from M/G/1 and M/G/c queueing approximations
+ */
+
+#ifndef QUEUEING_ESTIMATOR_H
+#define QUEUEING_ESTIMATOR_H
+
+/******************************Project Headers*****************************************/
+#include "Order.h"
+#include "Product.h"
+#include "DiscreteEventSimulator.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+/*************************************************************************************/
+
+/****************************QueueingEstimate Structure*******************************/
+/**
+ * @struct QueueingEstimate
+ * @brief The four KPIs (same definitions as SimulationResult) and the queue parameters behind them
+ */
+struct QueueingEstimate {
+    double avg_lead_time;                // Minutes
+    double station_utilization;          // Slot-minutes assembling / available over the makespan
+    double throughput;                   // Orders per hour
+    double agv_utilization;
+    int orders;                          // Orders with a known product
+    double arrival_rate;                 // Orders per minute (Poisson assumed)
+    double makespan_minutes;
+    double station_load;                 // rho = lambda E[S] / slots; a slot is held while components arrive
+    double station_service_minutes;      // E[S] = AGV wait + delivery + assembly
+    double station_service_scv;          // Squared coefficient of variation of S
+    double station_wait_minutes;         // Queue wait before a slot
+    double trips_per_order;              // Component trips plus the finished-product return
+    double trip_minutes;                 // E[T] of an AGV task
+    double agv_load;                     // rho = trip rate E[T] / AGVs at the order rate the station allows
+    double agv_wait_minutes;             // Task wait for an idle AGV
+    bool saturated;                      // rho >= 1 somewhere: fluid backlog instead of a steady state
+    double microseconds;                 // Wall-clock time of the estimate
+
+    QueueingEstimate()
+        : avg_lead_time(0.0), station_utilization(0.0), throughput(0.0), agv_utilization(0.0), orders(0),
+          arrival_rate(0.0), makespan_minutes(0.0), station_load(0.0), station_service_minutes(0.0),
+          station_service_scv(0.0), station_wait_minutes(0.0), trips_per_order(0.0), trip_minutes(0.0),
+          agv_load(0.0), agv_wait_minutes(0.0), saturated(false), microseconds(0.0) {}
+};
+/*************************************************************************************/
+
+/****************************QueueingEstimator Class**********************************/
+/**
+ * @class QueueingEstimator
+ * @brief Closed-form capacity estimate from the same inputs as a deterministic run
+ *
+ * The AGV fleet is an M/G/c queue of transport tasks: one trip per BOM
+ * unit (leaf components) and one finished-product return per order, with
+ * the trip time from the leg distributions or the layout. Each station
+ * slot is held from reservation until assembly ends, so the station is an
+ * M/G/c queue (M/G/1 for one slot) whose service time is the AGV wait, the
+ * delivery of the order's burst of trips (the slowest trip, or the fleet's
+ * share of the burst) and calculate_operation_time (T_base plus the
+ * expected setup, scaled by the assembly factor). The fleet only sees
+ * orders as fast as the station starts them, so the two queues are solved
+ * together by fixed-point iteration. Waits use the Pollaczek-Khinchine
+ * formula for one server and the Allen-Cunneen approximation otherwise.
+ * When orders arrive faster than the station or the fleet can take them
+ * there is no steady state; the wait is then the average of the linearly
+ * growing backlog over the order book. Lot batching, routings, congestion
+ * and batteries are not modeled.
+ */
+class QueueingEstimator {
+public:
+    explicit QueueingEstimator(const SimulationConfig& config);
+
+    QueueingEstimate estimate(const std::vector<Order>& orders,
+                              const std::map<std::string, Product>& products) const;
+
+    static double erlang_c(int servers, double offered_load);
+    static double mgc_wait(int servers, double arrival_rate, double mean_service, double service_scv);
+
+private:
+    /**
+     * @struct Moments
+     * @brief First two moments of a duration
+     */
+    struct Moments {
+        double mean;
+        double second;
+
+        Moments() : mean(0.0), second(0.0) {}
+        void add(double m, double variance) { second += variance + 2.0 * mean * m + m * m; mean += m; }
+    };
+
+    const SimulationConfig& config;
+
+    double average_speed() const;
+    Moments trip_moments(const std::string& item_id, bool is_finished_product, double speed) const;
+    double expected_setup(const std::map<std::string, int>& product_mix, int orders) const;
+};
+/*************************************************************************************/
+#endif /* QUEUEING_ESTIMATOR_H */
@@ -0,0 +1,162 @@
+/**
+ * @file ReplicationRunner.cpp
+ * @brief Parallel Monte Carlo replication implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "ReplicationRunner.h"
+#include "RandomStream.h"
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+/*************************************************************************************/
+
+/****************************Helper Functions*****************************************/
+namespace {
+/**
+ * @brief Two-sided 95% Student-t quantile for the given degrees of freedom
+ */
+double t_quantile_95(int df) {
+    static const double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    if (df <= 0) return 0.0;
+    if (df <= 30) return table[df - 1];
+    return 1.96 + 2.37 / df;  // Cornish-Fisher first-order correction
+}
+
+KpiEstimate estimate(const std::vector<double>& values) {
+    KpiEstimate e;
+    size_t n = values.size();
+    if (n == 0) return e;
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    e.mean = sum / n;
+    if (n > 1) {
+        double ss = 0.0;
+        for (double v : values) ss += (v - e.mean) * (v - e.mean);
+        e.stddev = std::sqrt(ss / (n - 1));
+        e.half_width = t_quantile_95((int)n - 1) * e.stddev / std::sqrt((double)n);
+    }
+    return e;
+}
+
+KpiEstimate estimate_field(const std::vector<SimulationResult>& runs, double SimulationResult::*field) {
+    std::vector<double> values;
+    values.reserve(runs.size());
+    for (const auto& r : runs) values.push_back(r.*field);
+    return estimate(values);
+}
+
+KpiEstimate estimate_paired(const std::vector<SimulationResult>& a, const std::vector<SimulationResult>& b,
+                            double SimulationResult::*field) {
+    std::vector<double> values;
+    size_t n = std::min(a.size(), b.size());
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) values.push_back(a[i].*field - b[i].*field);
+    return estimate(values);
+}
+}
+/*************************************************************************************/
+
+/****************************ReplicationRunner Methods*******************************/
+/**
+ * @brief Constructor for ReplicationRunner (inputs are shared read-only by all replications)
+ */
+ReplicationRunner::ReplicationRunner(const std::vector<Order>& ords,
+                                     const std::map<std::string, Product>& prods,
+                                     const std::map<std::string, int>& inv)
+    : orders(ords), products(prods), inventory(inv), threads(0) {
+}
+
+
+/**
+ * @brief Seed of replication r derived from the base seed
+ */
+uint64_t ReplicationRunner::replication_seed(uint64_t base_seed, int replication) {
+    return RandomStream::mix(base_seed * 0x9E3779B97F4A7C15ULL + (uint64_t)replication + 1);
+}
+
+
+/**
+ * @brief Run the replications in parallel
+ * @param base Configuration shared by all replications (its seed is the base seed)
+ * @param replications Number of replications
+ * @return One result per replication, indexed by replication number
+ */
+std::vector<SimulationResult> ReplicationRunner::run(const SimulationConfig& base, int replications) const {
+    std::vector<SimulationResult> results(std::max(replications, 0));
+    if (results.empty()) return results;
+
+    int workers = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+    workers = std::max(1, std::min(workers, replications));
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        int r;
+        while ((r = next.fetch_add(1)) < replications) {
+            SimulationConfig config = base;
+            config.seed = replication_seed(base.seed, r);
+            config.diag_logging = false;
+            std::vector<Order> order_book = orders;
+            DiscreteEventSimulator simulator(config);
+            results[r] = simulator.run(order_book, products, inventory);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; ++w) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    return results;
+}
+
+
+/**
+ * @brief Mean and 95% confidence interval of each KPI
+ */
+ReplicationSummary ReplicationRunner::summarize(const std::vector<SimulationResult>& runs) {
+    ReplicationSummary s;
+    s.replications = (int)runs.size();
+    s.avg_lead_time = estimate_field(runs, &SimulationResult::avg_lead_time);
+    s.station_utilization = estimate_field(runs, &SimulationResult::station_utilization);
+    s.throughput = estimate_field(runs, &SimulationResult::throughput);
+    s.agv_utilization = estimate_field(runs, &SimulationResult::agv_utilization);
+    return s;
+}
+
+
+/**
+ * @brief Paired-difference estimates (a - b), replication by replication
+ */
+ReplicationSummary ReplicationRunner::summarize_difference(const std::vector<SimulationResult>& a,
+                                                           const std::vector<SimulationResult>& b) {
+    ReplicationSummary s;
+    s.replications = (int)std::min(a.size(), b.size());
+    s.avg_lead_time = estimate_paired(a, b, &SimulationResult::avg_lead_time);
+    s.station_utilization = estimate_paired(a, b, &SimulationResult::station_utilization);
+    s.throughput = estimate_paired(a, b, &SimulationResult::throughput);
+    s.agv_utilization = estimate_paired(a, b, &SimulationResult::agv_utilization);
+    return s;
+}
+
+
+/**
+ * @brief Format a summary as a report section
+ */
+std::string ReplicationRunner::format_summary(const std::string& title, const ReplicationSummary& summary) {
+    std::stringstream ss;
+    ss << title << " (" << summary.replications << " replications, mean +/- 95% CI half-width)\n";
+    ss << std::fixed << std::setprecision(3);
+    ss << "  Average Lead Time: " << summary.avg_lead_time.mean << " +/- " << summary.avg_lead_time.half_width << " minutes\n";
+    ss << "  Assembly Station Utilization: " << summary.station_utilization.mean * 100 << " +/- "
+       << summary.station_utilization.half_width * 100 << " %\n";
+    ss << "  Throughput: " << summary.throughput.mean << " +/- " << summary.throughput.half_width << " orders/hour\n";
+    ss << "  Average AGV Utilization: " << summary.agv_utilization.mean * 100 << " +/- "
+       << summary.agv_utilization.half_width * 100 << " %\n";
+    return ss.str();
+}
+/*************************************************************************************/
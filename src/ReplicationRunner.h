@@ -0,0 +1,84 @@
+/**
+ * @file ReplicationRunner.h
+ * @brief Parallel Monte Carlo replications of the discrete-event model
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+/******************************Project Headers*****************************************/
+#include "Order.h"
+#include "Product.h"
+#include "DiscreteEventSimulator.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+/*************************************************************************************/
+
+/****************************Replication Statistics***********************************/
+/**
+ * @struct KpiEstimate
+ * @brief Sample mean of a KPI with a 95% Student-t confidence interval
+ */
+struct KpiEstimate {
+    double mean;
+    double stddev;
+    double half_width;
+
+    KpiEstimate() : mean(0.0), stddev(0.0), half_width(0.0) {}
+    double lower() const { return mean - half_width; }
+    double upper() const { return mean + half_width; }
+};
+
+/**
+ * @struct ReplicationSummary
+ * @brief KPI estimates over a set of replications
+ */
+struct ReplicationSummary {
+    int replications;
+    KpiEstimate avg_lead_time;
+    KpiEstimate station_utilization;
+    KpiEstimate throughput;
+    KpiEstimate agv_utilization;
+
+    ReplicationSummary() : replications(0) {}
+};
+/*************************************************************************************/
+
+/****************************ReplicationRunner Class**********************************/
+/**
+ * @class ReplicationRunner
+ * @brief Runs N independent replications on all cores and summarizes the KPIs
+ *
+ * Replication r always uses seed replication_seed(base_seed, r), whatever the
+ * thread count, so results are reproducible. Two configurations run with the
+ * same base seed share their random streams (common random numbers), which
+ * makes summarize_difference() a paired comparison.
+ */
+class ReplicationRunner {
+public:
+    ReplicationRunner(const std::vector<Order>& orders,
+                      const std::map<std::string, Product>& products,
+                      const std::map<std::string, int>& inventory);
+
+    void set_threads(int n) { threads = n; }
+    std::vector<SimulationResult> run(const SimulationConfig& base, int replications) const;
+
+    static uint64_t replication_seed(uint64_t base_seed, int replication);
+    static ReplicationSummary summarize(const std::vector<SimulationResult>& runs);
+    static ReplicationSummary summarize_difference(const std::vector<SimulationResult>& a,
+                                                   const std::vector<SimulationResult>& b);
+    static std::string format_summary(const std::string& title, const ReplicationSummary& summary);
+
+private:
+    const std::vector<Order>& orders;
+    const std::map<std::string, Product>& products;
+    const std::map<std::string, int>& inventory;
+    int threads;                        // 0 = hardware concurrency
+};
+/*************************************************************************************/
+#endif /* REPLICATION_RUNNER_H */
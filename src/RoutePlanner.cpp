@@ -0,0 +1,204 @@
+/**
+ * @file RoutePlanner.cpp
+ * @brief Space-time reservation routing implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "RoutePlanner.h"
+#include <queue>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+/*************************************************************************************/
+
+namespace {
+const double PURGE_INTERVAL_MINUTES = 60.0;
+const int MAX_ENTRY_ITERATIONS = 64;
+}
+
+/****************************RoutePlanner Methods************************************/
+/**
+ * @brief Constructor for RoutePlanner
+ * @param floor Built layout (must outlive the planner)
+ */
+RoutePlanner::RoutePlanner(const Layout& floor)
+    : layout(floor),
+      last_purge(0.0),
+      plans(0),
+      expansions(0),
+      forced_entries(0),
+      search_id(0) {
+    reset();
+}
+
+
+/**
+ * @brief Drop all reservations
+ */
+void RoutePlanner::reset() {
+    int n = layout.node_count();
+    aisle_blocks.assign(layout.aisle_count(), IntervalSet());
+    node_blocks.assign(n, IntervalSet());
+    arrival.assign(n, 0.0);
+    entered.assign(n, 0.0);
+    parent.assign(n, -1);
+    via.assign(n, nullptr);
+    stamp.assign(n, 0);
+    search_id = 0;
+    last_purge = 0.0;
+}
+
+
+/**
+ * @brief Earliest time >= t that is not inside a blocked interval
+ */
+double RoutePlanner::next_free(const IntervalSet& blocks, double t) {
+    auto it = blocks.upper_bound(t);
+    if (it != blocks.begin()) {
+        --it;
+        if (it->second > t) return it->second;   // Intervals are disjoint: the end is free
+    }
+    return t;
+}
+
+
+/**
+ * @brief Add a blocked interval, merging it with overlapping ones
+ */
+void RoutePlanner::block(IntervalSet& blocks, double start, double end) {
+    if (end <= start) return;
+    auto it = blocks.upper_bound(start);
+    if (it != blocks.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second >= start) {
+            start = prev->first;
+            end = std::max(end, prev->second);
+            it = blocks.erase(prev);
+        }
+    }
+    while (it != blocks.end() && it->first <= end) {
+        end = std::max(end, it->second);
+        it = blocks.erase(it);
+    }
+    blocks.emplace_hint(it, start, end);
+}
+
+
+/**
+ * @brief Earliest time an AGV ready at 'ready' can enter the aisle without conflict
+ *
+ * Waiting happens at the aisle's start node. The entry is pushed back until
+ * both the aisle entry and the passage through the end junction are free.
+ * If that takes more than MAX_ENTRY_ITERATIONS steps, the last candidate is
+ * accepted despite its conflict and counted in forced_entries.
+ */
+double RoutePlanner::earliest_entry(const Layout::Aisle& aisle, double ready) {
+    double enter = ready;
+    for (int i = 0; i < MAX_ENTRY_ITERATIONS; ++i) {
+        enter = next_free(aisle_blocks[aisle.id], enter);
+        if (layout.is_dock(aisle.to)) return enter;
+        double arrive = enter + aisle.time_minutes;
+        double pass = next_free(node_blocks[aisle.to], arrive);
+        if (pass == arrive) return enter;
+        enter += pass - arrive;
+    }
+    forced_entries++;
+    return enter;
+}
+
+
+/**
+ * @brief Plan a move and reserve its aisles and junctions
+ * @param from Start node
+ * @param to Goal node
+ * @param depart Time the AGV is ready to leave
+ * @return Route with its arrival time; free-flow timing if the goal is unreachable
+ */
+PlannedRoute RoutePlanner::plan(int from, int to, double depart) {
+    PlannedRoute route;
+    route.depart = depart;
+    route.free_flow = layout.travel_time(from, to);
+    route.arrive = depart + route.free_flow;
+    plans++;
+    if (from == to || !layout.reachable(from, to)) {
+        route.nodes.push_back(from);
+        return route;
+    }
+    if (depart - last_purge >= PURGE_INTERVAL_MINUTES) purge(depart);
+
+    // Time-dependent A* (waiting is allowed, so earliest arrival is label-setting)
+    if (++search_id == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        search_id = 1;
+    }
+    typedef std::pair<double, int> Entry;   // (arrival + heuristic, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+    stamp[from] = search_id;
+    arrival[from] = depart;
+    parent[from] = -1;
+    via[from] = nullptr;
+    open.push(Entry(depart + route.free_flow, from));
+
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        int u = top.second;
+        if (top.first > arrival[u] + layout.travel_time(u, to)) continue;   // Stale entry
+        if (u == to) break;
+        expansions++;
+        for (const auto& aisle : layout.aisles_from(u)) {
+            double h = layout.travel_time(aisle.to, to);
+            if (h == std::numeric_limits<double>::infinity()) continue;
+            double enter = earliest_entry(aisle, arrival[u]);
+            double arrive = enter + aisle.time_minutes;
+            int v = aisle.to;
+            if (stamp[v] != search_id || arrive < arrival[v]) {
+                stamp[v] = search_id;
+                arrival[v] = arrive;
+                entered[v] = enter;
+                parent[v] = u;
+                via[v] = &aisle;
+                open.push(Entry(arrive + h, v));
+            }
+        }
+    }
+    route.arrive = arrival[to];
+
+    // Reserve the path back from the goal
+    double headway = layout.headway_minutes();
+    for (int v = to; v != from; v = parent[v]) {
+        const Layout::Aisle& aisle = *via[v];
+        int u = parent[v];
+        double enter = entered[v];
+        double arrive = arrival[v];
+        block(aisle_blocks[aisle.id], enter - headway, enter + headway);
+        if (aisle.reverse >= 0) {
+            block(aisle_blocks[aisle.reverse], enter - aisle.time_minutes, arrive);
+        }
+        if (!layout.is_dock(v)) block(node_blocks[v], arrive - headway, arrive + headway);
+        if (!layout.is_dock(u) && enter > arrival[u]) {
+            block(node_blocks[u], arrival[u] - headway, enter + headway);   // Standing in the junction while it waits
+        }
+        route.nodes.push_back(v);
+    }
+    route.nodes.push_back(from);
+    std::reverse(route.nodes.begin(), route.nodes.end());
+    return route;
+}
+
+
+/**
+ * @brief Remove intervals that ended before the given time
+ */
+void RoutePlanner::purge(double before) {
+    auto prune = [before](IntervalSet& blocks) {
+        for (auto it = blocks.begin(); it != blocks.end();) {
+            if (it->second < before) it = blocks.erase(it);
+            else ++it;
+        }
+    };
+    for (auto& blocks : aisle_blocks) prune(blocks);
+    for (auto& blocks : node_blocks) prune(blocks);
+    last_purge = before;
+}
+/*************************************************************************************/
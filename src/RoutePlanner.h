@@ -0,0 +1,88 @@
+/**
+ * @file RoutePlanner.h
+ * @brief Congestion-aware AGV routing with a space-time reservation table
+ */
+
+#ifndef ROUTE_PLANNER_H
+#define ROUTE_PLANNER_H
+
+/******************************Project Headers*****************************************/
+#include "Layout.h"
+/*************************************************************************************/
+
+/*****************************Standard Libraries***************************************/
+#include <map>
+#include <vector>
+#include <cstdint>
+/*************************************************************************************/
+
+/****************************RoutePlanner Class Definition****************************/
+/**
+ * @struct PlannedRoute
+ * @brief Result of one planned move
+ */
+struct PlannedRoute {
+    double depart;                       // Requested departure time
+    double arrive;                       // Arrival time including waits
+    double free_flow;                    // Travel time on an empty floor
+    std::vector<int> nodes;              // Visited nodes, from .. to
+
+    PlannedRoute() : depart(0.0), arrive(0.0), free_flow(0.0) {}
+    double delay() const { return arrive - depart - free_flow; }
+};
+
+/**
+ * @class RoutePlanner
+ * @brief Cooperative A*: each move is planned against the reservations of earlier moves
+ *
+ * The reservation table holds, per directed aisle and per junction node,
+ * disjoint time intervals in which entering is forbidden. A planned move
+ * reserves its aisles and junctions, so later moves wait (at the node
+ * before a blocked aisle) or take another route. Conflicts modeled:
+ *  - following: entries into the same aisle direction are one headway apart
+ *  - head-on: a two-way aisle is a single lane, opposite traversals cannot overlap
+ *  - crossing: junction passages are one headway apart
+ * Dock nodes (warehouse, station, home and storage nodes) have many bays and
+ * are never reserved. The free-flow travel-time matrix of the layout is the
+ * A* heuristic, so searches stay narrow.
+ *
+ * Moves must be planned in non-decreasing departure order (as an event
+ * queue does); intervals that ended before the latest departure are purged.
+ */
+class RoutePlanner {
+public:
+    explicit RoutePlanner(const Layout& floor);
+
+    PlannedRoute plan(int from, int to, double depart);
+    void reset();
+
+    long long get_plans() const { return plans; }
+    long long get_expansions() const { return expansions; }
+    long long get_forced_entries() const { return forced_entries; }
+
+private:
+    typedef std::map<double, double> IntervalSet;   // start -> end, disjoint
+
+    const Layout& layout;
+    std::vector<IntervalSet> aisle_blocks;         // By directed aisle id
+    std::vector<IntervalSet> node_blocks;          // By node
+    double last_purge;
+    long long plans;
+    long long expansions;
+    long long forced_entries;                      // Aisle entries taken despite a conflict (search limit hit)
+
+    // A* scratch space, valid for labels whose stamp equals search_id
+    std::vector<double> arrival;
+    std::vector<double> entered;                   // Entry time of the aisle into the node
+    std::vector<int> parent;
+    std::vector<const Layout::Aisle*> via;
+    std::vector<uint32_t> stamp;
+    uint32_t search_id;
+
+    static double next_free(const IntervalSet& blocks, double t);
+    static void block(IntervalSet& blocks, double start, double end);
+    double earliest_entry(const Layout::Aisle& aisle, double ready);
+    void purge(double before);
+};
+/*************************************************************************************/
+#endif /* ROUTE_PLANNER_H */
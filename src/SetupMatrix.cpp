@@ -0,0 +1,39 @@
+/**
+ * @file SetupMatrix.cpp
+ * @brief Sequence-dependent setup times implementation
+ */
+
+/******************************Project Headers*****************************************/
+#include "SetupMatrix.h"
+/*************************************************************************************/
+
+/****************************SetupMatrix Methods*************************************/
+/**
+ * @brief Family of a product (the product itself if it has none)
+ */
+const std::string& SetupMatrix::family_of(const std::string& product_id) const {
+    auto it = families.find(product_id);
+    return it != families.end() ? it->second : product_id;
+}
+
+
+/**
+ * @brief Changeover time before `to` when the slot last assembled `from`
+ * @param from Previous product on the slot (empty for the first order)
+ * @param to Next product
+ * @return Setup minutes
+ */
+int SetupMatrix::setup_minutes(const std::string& from, const std::string& to) const {
+    if (from.empty()) return default_minutes;
+
+    auto it = times.find(std::make_pair(from, to));
+    if (it != times.end()) return it->second;
+
+    const std::string& from_family = family_of(from);
+    const std::string& to_family = family_of(to);
+    it = times.find(std::make_pair(from_family, to_family));
+    if (it != times.end()) return it->second;
+
+    return from_family == to_family ? 0 : default_minutes;
+}
+/*************************************************************************************/
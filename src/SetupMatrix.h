@@ -0,0 +1,46 @@
+/**
+ * @file SetupMatrix.h
+ * @brief Sequence-dependent station setup times (from-product x to-product)
+ */
+
+#ifndef SETUP_MATRIX_H
+#define SETUP_MATRIX_H
+
+/*****************************Standard Libraries***************************************/
+#include <string>
+#include <map>
+#include <utility>
+/*************************************************************************************/
+
+/****************************SetupMatrix Class Definition*****************************/
+/**
+ * @class SetupMatrix
+ * @brief Changeover minutes between consecutive products at a station slot
+ *
+ * Entries are given per product pair or per product-family pair. A lookup
+ * tries the product pair, then the family pair; an unlisted changeover
+ * costs nothing within the same product or family and the default time
+ * otherwise. The first order on a slot (no previous product) always pays
+ * the default time.
+ */
+class SetupMatrix {
+public:
+    SetupMatrix() : default_minutes(5), loaded(false) {}
+
+    void set_default(int minutes) { default_minutes = minutes; loaded = true; }
+    void set_family(const std::string& product_id, const std::string& family) { families[product_id] = family; loaded = true; }
+    void set_time(const std::string& from, const std::string& to, int minutes) { times[std::make_pair(from, to)] = minutes; loaded = true; }
+
+    bool empty() const { return !loaded; }
+    int get_default() const { return default_minutes; }
+    const std::string& family_of(const std::string& product_id) const;
+    int setup_minutes(const std::string& from, const std::string& to) const;
+
+private:
+    int default_minutes;
+    bool loaded;
+    std::map<std::string, std::string> families;                  // Product -> family (unlisted: own family)
+    std::map<std::pair<std::string, std::string>, int> times;     // (from, to) products or families -> minutes
+};
+/*************************************************************************************/
+#endif /* SETUP_MATRIX_H */
@@ -0,0 +1,47 @@
+/**
+ * @file SimClock.h
+ * @brief Wall-clock pacing of the threaded simulation
+ */
+
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+/*****************************Standard Libraries***************************************/
+#include <atomic>
+#include <chrono>
+#include <thread>
+/*************************************************************************************/
+
+/****************************SimClock Class Definition*******************************/
+/**
+ * @class SimClock
+ * @brief Scales every simulation sleep by a global factor
+ *
+ * A scale of 1.0 keeps the nominal pacing (100 ms per AGV minute), smaller
+ * values run faster, and 0 disables sleeping entirely (threads only yield),
+ * which is what benchmarks and parameter sweeps use.
+ */
+class SimClock {
+public:
+    static void set_time_scale(double scale) { time_scale.store(scale < 0.0 ? 0.0 : scale); }
+    static double get_time_scale() { return time_scale.load(); }
+
+    /**
+     * @brief Sleep for a nominal number of milliseconds, scaled by the time scale
+     * @param nominal_ms Duration at scale 1.0
+     */
+    static void sleep_ms(int nominal_ms) {
+        double scale = time_scale.load(std::memory_order_relaxed);
+        long long us = (long long)(nominal_ms * 1000.0 * scale);
+        if (us <= 0) {
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+
+private:
+    static inline std::atomic<double> time_scale{1.0};
+};
+/*************************************************************************************/
+#endif /* SIM_CLOCK_H */
@@ -0,0 +1,59 @@
+/**
+ * @file TaskLatch.h
+ * @brief In-flight transport counter used to drain the fleet at shutdown
+ */
+
+#ifndef TASK_LATCH_H
+#define TASK_LATCH_H
+
+/*****************************Standard Libraries***************************************/
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+/*************************************************************************************/
+
+/****************************TaskLatch Class Definition******************************/
+/**
+ * @class TaskLatch
+ * @brief Counts accepted AGV tasks and wakes a waiter when the count drops to zero
+ *
+ * An AGV calls begin() when it accepts a task and end() when it is idle
+ * again. stop_simulation() waits on wait_idle(), which returns the moment
+ * the last task finishes instead of polling every AGV.
+ */
+class TaskLatch {
+public:
+    TaskLatch() : in_flight(0) {}
+
+    void begin() {
+        std::lock_guard<std::mutex> lock(latch_mutex);
+        in_flight++;
+    }
+
+    void end() {
+        std::lock_guard<std::mutex> lock(latch_mutex);
+        if (in_flight > 0 && --in_flight == 0) idle_cv.notify_all();
+    }
+
+    int count() const {
+        std::lock_guard<std::mutex> lock(latch_mutex);
+        return in_flight;
+    }
+
+    /**
+     * @brief Block until no task is in flight
+     * @param timeout Upper bound on the wait (wall clock)
+     * @return false if tasks were still in flight when the timeout expired
+     */
+    bool wait_idle(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(latch_mutex);
+        return idle_cv.wait_for(lock, timeout, [this] { return in_flight == 0; });
+    }
+
+private:
+    mutable std::mutex latch_mutex;
+    std::condition_variable idle_cv;
+    int in_flight;
+};
+/*************************************************************************************/
+#endif /* TASK_LATCH_H */
@@ -65,6 +65,29 @@ bool Warehouse::reserve_components(const std::map<std::string, int>& required) {
 }
 
 
+/**
+ * @brief Reserve an exploded BOM atomically
+ * @param required Leaf requirements per unit (Product::leaf_requirements)
+ * @param multiplier Units to reserve for (a lot)
+ * @return true if reservation is successful, false otherwise
+ */
+bool Warehouse::reserve_components(const std::vector<ComponentRequirement>& required, int multiplier) {
+    std::lock_guard<std::mutex> lock(inventory_mutex);
+
+    for (const auto& req : required) {
+        auto it = components.find(req.component_id);
+        if (it == components.end() || it->second < req.quantity * multiplier) {
+            return false;
+        }
+    }
+
+    for (const auto& req : required) {
+        components[req.component_id] -= req.quantity * multiplier;
+    }
+    return true;
+}
+
+
 /**
  * @brief Add components to the warehouse inventory
  * @param component_id The ID of the component
@@ -91,10 +114,11 @@ int Warehouse::get_component_quantity(const std::string& component_id) const {
 /**
  * @brief Add a finished product to the warehouse inventory
  * @param product_id The ID of the finished product
+ * @param quantity Units delivered (a lot carries several)
  */
-void Warehouse::add_finished_product(const std::string& product_id) {
+void Warehouse::add_finished_product(const std::string& product_id, int quantity) {
     std::lock_guard<std::mutex> lock(inventory_mutex);
-    finished_products[product_id]++;
+    finished_products[product_id] += quantity;
 }
 
 
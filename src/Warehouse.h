@@ -6,9 +6,14 @@
 #ifndef WAREHOUSE_H
 #define WAREHOUSE_H
 
+/******************************Project Headers*****************************************/
+#include "Product.h"
+/*************************************************************************************/
+
 /*****************************Standard Libraries***************************************/
 #include <string>
 #include <map>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 /*************************************************************************************/
@@ -26,11 +31,12 @@ public:
     // Component management
     bool has_components(const std::map<std::string, int>& required);
     bool reserve_components(const std::map<std::string, int>& required);  // Checks and reserves atomically
+    bool reserve_components(const std::vector<ComponentRequirement>& required, int multiplier = 1);
     void add_component(const std::string& component_id, int quantity);
     int get_component_quantity(const std::string& component_id) const;
     
     // Finished product management
-    void add_finished_product(const std::string& product_id);
+    void add_finished_product(const std::string& product_id, int quantity = 1);
     int get_finished_product_count(const std::string& product_id) const;
     
     // Inventory status
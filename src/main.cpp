@@ -11,6 +11,11 @@
 #include <memory>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <cstdlib>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
 /*************************************************************************************/
 
 /*****************************Project Headers*****************************************/
@@ -19,6 +24,12 @@
 #include "Warehouse.h"
 #include "AGV.h"
 #include "FileHandler.h"
+#include "SimClock.h"
+#include "DiscreteEventSimulator.h"
+#include "ReplicationRunner.h"
+#include "QueueingEstimator.h"
+#include "ConfigOptimizer.h"
+#include <fstream>
 /*************************************************************************************/
 
 /********************************Variables********************************************/
@@ -28,11 +39,282 @@ const std::string BOM_FILE = "input/bom.txt";
 const std::string WAREHOUSE_FILE = "input/warehouse.txt";
 const std::string LOG_FILE = "output/sim_log.txt";
 const std::string KPI_REPORT_FILE = "output/kpi_report.txt";
+const std::string KPI_TIMESERIES_FILE = "output/kpi_timeseries.csv";
+const std::string AGV_REPORT_FILE = "output/agv_report.txt";
+const std::string DISTRIBUTIONS_FILE = "input/distributions.txt";   // Optional
+const std::string LAYOUT_FILE = "input/layout.txt";                 // Optional
+const std::string BATTERY_FILE = "input/battery.txt";               // Optional
+const std::string FLEET_FILE = "input/fleet.txt";                   // Optional
+const std::string SETUP_FILE = "input/setup.txt";                   // Optional
+const std::string ROUTING_FILE = "input/routing.txt";               // Optional
+const std::string MRP_REPORT_FILE = "output/mrp_report.txt";
+const std::string REPLICATION_REPORT_FILE = "output/replication_report.txt";
+const std::string OPTIMIZER_REPORT_FILE = "output/optimizer_report.txt";
+const double TIME_SCALE = 1.0;      // Wall-clock pacing: 1.0 nominal, 0 runs as fast as possible
+const int KPI_WINDOW_MINUTES = 15;  // Bucket size of the KPI time series (0 disables it)
 
 /*************************************************************************************/
 
+/****************************Command Line********************************************/
+/**
+ * @struct RunOptions
+ * @brief Options selected on the command line
+ */
+struct RunOptions {
+    bool deterministic;          // Single-threaded discrete-event run
+    unsigned long long seed;
+    int num_agvs;
+    SchedulingPolicy policy;
+    std::string distributions_file;
+    std::string layout_file;
+    std::string battery_file;
+    std::string fleet_file;
+    std::string setup_file;
+    std::string routing_file;
+    int station_buffer;          // Routed jobs the station's output buffer holds (-1: unlimited)
+    int lookahead;               // SETUP policy look-ahead window (queued orders)
+    bool congestion;             // Congestion-aware routing on the layout
+    double dispatch_cycle;       // > 0: joint task assignment every N minutes (layout only)
+    bool backhaul;               // Component AGVs carry finished products back
+    int station_slots;           // Orders the station assembles in parallel
+    int lot_window;              // > 0: batch same-product orders released within N minutes
+    int lot_size;                // Lot size cap (0: window only)
+    int replications;            // > 0: Monte Carlo replication mode
+    int optimize;                // > 0: configuration search with this many simulation runs
+    int threads;                 // Replication and MRP worker threads (0 = all cores)
+    bool estimate;               // Analytical queueing estimate (next to the simulated KPIs when deterministic)
+    bool keep_unbuildable;       // Run orders the MRP pass finds unbuildable (they cancel at runtime)
+    bool compare;                // Paired comparison against compare_policy
+    SchedulingPolicy compare_policy;
+
+    RunOptions() : deterministic(false), seed(1), num_agvs(NUM_AGVS), policy(SchedulingPolicy::FIFO),
+                   distributions_file(DISTRIBUTIONS_FILE), layout_file(LAYOUT_FILE), battery_file(BATTERY_FILE), fleet_file(FLEET_FILE), setup_file(SETUP_FILE), routing_file(ROUTING_FILE), station_buffer(-1), lookahead(8), congestion(false), dispatch_cycle(0.0), backhaul(false), station_slots(1), lot_window(0), lot_size(0), replications(0), optimize(0), threads(0), estimate(false), keep_unbuildable(false),
+                   compare(false), compare_policy(SchedulingPolicy::FIFO) {}
+};
+
+static void print_usage() {
+    std::cerr << "Usage: fas_simulator [--deterministic] [--estimate] [--seed N] [--agvs N]\n"
+                 "                     [--policy fifo|priority|spt|edd|setup] [--lookahead N]\n"
+                 "                     [--distributions FILE] [--setup FILE] [--routing FILE [--station-buffer N]]\n"
+                 "                     [--layout FILE [--congestion] [--dispatch-cycle MIN]]\n"
+                 "                     [--backhaul] [--station-slots N] [--lot-window MIN [--lot-size N]]\n"
+                 "                     [--battery FILE] [--fleet FILE] [--keep-unbuildable] [--threads N]\n"
+                 "                     [--replications N [--compare-policy P]] [--optimize RUNS]\n"
+                 "  --deterministic  single-threaded event simulation; identical inputs and seed\n"
+                 "                   give identical event sequences and KPIs\n"
+                 "  --estimate       analytical KPI estimate (M/G/1, M/G/c queueing approximations) in\n"
+                 "                   microseconds instead of a simulation; with --deterministic it is\n"
+                 "                   printed next to the simulated KPIs\n"
+                 "  --policy         fifo and priority run in every mode; spt, edd and setup need an\n"
+                 "                   event-driven mode (--deterministic, --replications, --optimize)\n"
+                 "  --policy setup   event-driven modes: among the next N queued orders (--lookahead,\n"
+                 "                   default 8, in due-date order) start the one with the shortest\n"
+                 "                   changeover unless that makes an earlier order miss its due date\n"
+                 "  --setup          sequence-dependent setup times per product or family pair\n"
+                 "                   (default " << SETUP_FILE << " if present; otherwise a flat 5 minutes)\n"
+                 "  --routing        event-driven modes: workcenters and per-product operations after\n"
+                 "                   assembly; AGVs move the work in process between them\n"
+                 "                   (default " << ROUTING_FILE << " if present)\n"
+                 "  --station-buffer routed jobs waiting for pickup at the station (default unlimited);\n"
+                 "                   when full, a finished assembly blocks its slot\n"
+                 "  --distributions  event-driven modes: process-time distributions\n"
+                 "                   (default " << DISTRIBUTIONS_FILE << " if present)\n"
+                 "  --layout         shop-floor graph for AGV travel times (default " << LAYOUT_FILE << " if present)\n"
+                 "  --congestion     event-driven modes: AGVs reserve aisles and wait or reroute\n"
+                 "                   around each other (space-time reservation table)\n"
+                 "  --dispatch-cycle event-driven modes: collect transport tasks and assign them\n"
+                 "                   to idle AGVs jointly (Hungarian algorithm) every MIN minutes\n"
+                 "  --backhaul       an AGV that drops components at the station takes a waiting\n"
+                 "                   finished product back (RETURNING leg) instead of leaving empty\n"
+                 "  --station-slots  orders the station assembles in parallel (fixtures or\n"
+                 "                   operators, default 1); components are routed to their slot\n"
+                 "  --lot-window     merge orders of the same product released within MIN minutes\n"
+                 "                   into one lot (one setup, one reservation, shared transports);\n"
+                 "                   --lot-size closes a lot early at N orders\n"
+                 "  --battery        event-driven modes: AGV state of charge and chargers\n"
+                 "                   (default " << BATTERY_FILE << " if present)\n"
+                 "  --fleet          vehicle types, speeds, payloads and permitted items; sets the\n"
+                 "                   fleet size (default " << FLEET_FILE << " if present)\n"
+                 "  --keep-unbuildable run orders the pre-run MRP pass finds unbuildable (stock can\n"
+                 "                   never cover them) instead of canceling them; see " << MRP_REPORT_FILE << "\n"
+                 "  --threads        worker threads for replications and the MRP pass (default all cores)\n"
+                 "  --replications   run N seeded replications on all cores and report 95% CIs\n"
+                 "  --compare-policy paired comparison (common random numbers) against policy P\n"
+                 "  --optimize       search fleet sizes 1..--agvs and scheduling policies with a budget\n"
+                 "                   of RUNS simulations; reports the Pareto front of throughput,\n"
+                 "                   fleet size and lead time in " << OPTIMIZER_REPORT_FILE << "\n";
+}
+
+static std::string buffer_size(int capacity) {
+    return capacity < 0 ? "unlimited" : std::to_string(capacity);
+}
+
+static void print_estimate(const QueueingEstimate& e, const SimulationResult* sim) {
+    std::cout << "\nAnalytical estimate (" << e.orders << " orders, " << e.microseconds << " us):\n";
+    std::cout << std::setfill(' ') << std::left << std::setw(30) << "" << std::right << std::setw(12) << "Estimate";
+    if (sim) std::cout << std::setw(12) << "Simulated" << std::setw(10) << "Error";
+    std::cout << "\n";
+    const char* names[] = { "Average Lead Time (min)", "Station Utilization (%)", "Throughput (orders/hour)",
+                            "AGV Utilization (%)" };
+    double estimated[] = { e.avg_lead_time, 100 * e.station_utilization, e.throughput, 100 * e.agv_utilization };
+    double simulated[] = { 0.0, 0.0, 0.0, 0.0 };
+    if (sim) {
+        simulated[0] = sim->avg_lead_time;
+        simulated[1] = 100 * sim->station_utilization;
+        simulated[2] = sim->throughput;
+        simulated[3] = 100 * sim->agv_utilization;
+    }
+    for (int k = 0; k < 4; ++k) {
+        std::cout << std::left << std::setw(30) << names[k] << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << estimated[k];
+        if (sim) {
+            std::cout << std::setw(12) << simulated[k];
+            if (simulated[k] != 0.0) std::cout << std::setw(9) << 100 * (estimated[k] - simulated[k]) / simulated[k] << "%";
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "   station rho " << e.station_load << " (slot held " << e.station_service_minutes << " min, cs^2 "
+              << e.station_service_scv << ", queue wait " << e.station_wait_minutes << " min)\n";
+    std::cout << "   AGV rho " << e.agv_load << " (" << e.trips_per_order << " trips/order of " << e.trip_minutes
+              << " min, wait " << e.agv_wait_minutes << " min)\n";
+    if (e.saturated) {
+        std::cout << "   Warning: rho >= 1, no steady state; lead time is the average of a growing backlog\n";
+    }
+}
+
+static bool parse_policy(const std::string& name, SchedulingPolicy& policy) {
+    if (name == "fifo") policy = SchedulingPolicy::FIFO;
+    else if (name == "priority") policy = SchedulingPolicy::PRIORITY;
+    else if (name == "spt") policy = SchedulingPolicy::SPT;
+    else if (name == "edd") policy = SchedulingPolicy::EDD;
+    else if (name == "setup") policy = SchedulingPolicy::SETUP;
+    else return false;
+    return true;
+}
+
+static std::string policy_name(SchedulingPolicy policy) {
+    switch (policy) {
+        case SchedulingPolicy::PRIORITY: return "PRIORITY";
+        case SchedulingPolicy::SPT:      return "SPT";
+        case SchedulingPolicy::EDD:      return "EDD";
+        case SchedulingPolicy::SETUP:    return "SETUP";
+        case SchedulingPolicy::FIFO:
+        default:                         return "FIFO";
+    }
+}
+
+/**
+ * @brief The run uses the threaded engine (--estimate alone runs no schedule)
+ */
+static bool runs_threaded(const RunOptions& opts) {
+    return !opts.deterministic && opts.replications == 0 && opts.optimize == 0 && !opts.estimate;
+}
+
+/**
+ * @brief First option in use that only the event-driven modes model ("" if none)
+ *
+ * The threaded scheduler only orders by release time or priority.
+ */
+static std::string event_only_option(const RunOptions& opts) {
+    if (opts.policy != SchedulingPolicy::FIFO && opts.policy != SchedulingPolicy::PRIORITY) {
+        std::string name = policy_name(opts.policy);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return "--policy " + name;
+    }
+    if (opts.distributions_file != DISTRIBUTIONS_FILE) return "--distributions";
+    if (opts.congestion) return "--congestion";
+    if (opts.dispatch_cycle > 0.0) return "--dispatch-cycle";
+    if (opts.battery_file != BATTERY_FILE) return "--battery";
+    if (opts.routing_file != ROUTING_FILE) return "--routing";
+    if (opts.station_buffer >= 0) return "--station-buffer";
+    return "";
+}
+
+static bool parse_arguments(int argc, char* argv[], RunOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--deterministic") {
+            opts.deterministic = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--agvs" && i + 1 < argc) {
+            opts.num_agvs = std::atoi(argv[++i]);
+            if (opts.num_agvs <= 0) return false;
+        } else if (arg == "--policy" && i + 1 < argc) {
+            if (!parse_policy(argv[++i], opts.policy)) return false;
+        } else if (arg == "--lookahead" && i + 1 < argc) {
+            opts.lookahead = std::atoi(argv[++i]);
+            if (opts.lookahead <= 0) return false;
+        } else if (arg == "--setup" && i + 1 < argc) {
+            opts.setup_file = argv[++i];
+        } else if (arg == "--routing" && i + 1 < argc) {
+            opts.routing_file = argv[++i];
+        } else if (arg == "--station-buffer" && i + 1 < argc) {
+            opts.station_buffer = std::atoi(argv[++i]);
+            if (opts.station_buffer < 0) return false;
+        } else if (arg == "--distributions" && i + 1 < argc) {
+            opts.distributions_file = argv[++i];
+        } else if (arg == "--layout" && i + 1 < argc) {
+            opts.layout_file = argv[++i];
+        } else if (arg == "--congestion") {
+            opts.congestion = true;
+        } else if (arg == "--fleet" && i + 1 < argc) {
+            opts.fleet_file = argv[++i];
+        } else if (arg == "--battery" && i + 1 < argc) {
+            opts.battery_file = argv[++i];
+        } else if (arg == "--backhaul") {
+            opts.backhaul = true;
+        } else if (arg == "--lot-window" && i + 1 < argc) {
+            opts.lot_window = std::atoi(argv[++i]);
+            if (opts.lot_window <= 0) return false;
+        } else if (arg == "--lot-size" && i + 1 < argc) {
+            opts.lot_size = std::atoi(argv[++i]);
+            if (opts.lot_size <= 0) return false;
+        } else if (arg == "--station-slots" && i + 1 < argc) {
+            opts.station_slots = std::atoi(argv[++i]);
+            if (opts.station_slots <= 0) return false;
+        } else if (arg == "--dispatch-cycle" && i + 1 < argc) {
+            opts.dispatch_cycle = std::atof(argv[++i]);
+            if (opts.dispatch_cycle <= 0.0) return false;
+        } else if (arg == "--replications" && i + 1 < argc) {
+            opts.replications = std::atoi(argv[++i]);
+            if (opts.replications <= 0) return false;
+        } else if (arg == "--optimize" && i + 1 < argc) {
+            opts.optimize = std::atoi(argv[++i]);
+            if (opts.optimize <= 0) return false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opts.threads = std::atoi(argv[++i]);
+        } else if (arg == "--estimate") {
+            opts.estimate = true;
+        } else if (arg == "--keep-unbuildable") {
+            opts.keep_unbuildable = true;
+        } else if (arg == "--compare-policy" && i + 1 < argc) {
+            if (!parse_policy(argv[++i], opts.compare_policy)) return false;
+            opts.compare = true;
+        } else {
+            return false;
+        }
+    }
+    if (opts.lot_size > 0 && opts.lot_window <= 0) return false;   // A lot needs a window to close
+    std::string event_only = runs_threaded(opts) ? event_only_option(opts) : "";
+    if (!event_only.empty()) {
+        std::cerr << "Error: " << event_only << " needs an event-driven mode"
+                  << " (--deterministic, --replications or --optimize)" << std::endl;
+        return false;
+    }
+    return true;
+}
+/*************************************************************************************/
+
 /*******************************Main Function*****************************************/
 int main(int argc, char* argv[]) {
+    RunOptions opts;
+    if (!parse_arguments(argc, argv, opts)) {
+        print_usage();
+        return 1;
+    }
+
     std::cout << "========================================\n";
     std::cout << "  Flexible Assembly System Simulator  \n";
     std::cout << "  (    Tarek Abouelezz    )              \n";
@@ -71,19 +353,294 @@ int main(int argc, char* argv[]) {
     }
     std::cout << "   Loaded warehouse inventory from " << WAREHOUSE_FILE << std::endl;
     
+    // Per-window KPI time series streamed while the simulation runs
+    control_center.set_kpi_window(KPI_WINDOW_MINUTES, KPI_TIMESERIES_FILE);
+
+    // Optional: silence diagnostics for final runs
+    // control_center.set_diag_logging(false);
+
+    // Optional process-time distributions (event-driven modes)
+    ProcessTimeModel process_times;
+    if (runs_threaded(opts) && FileHandler::file_exists(opts.distributions_file)) {
+        std::cout << "   Ignoring " << opts.distributions_file << " (process-time distributions need an event-driven mode)"
+                  << std::endl;
+    } else if (FileHandler::file_exists(opts.distributions_file)) {
+        if (!FileHandler::read_distributions_file(opts.distributions_file, process_times)) {
+            std::cerr << "Error: Failed to load distributions file: " << opts.distributions_file << std::endl;
+            return 1;
+        }
+        std::cout << "   Loaded process-time distributions from " << opts.distributions_file << std::endl;
+    } else if (opts.distributions_file != DISTRIBUTIONS_FILE) {
+        std::cerr << "Error: Cannot open file " << opts.distributions_file << std::endl;
+        return 1;
+    }
+
+    // Optional shop-floor layout (all modes)
+    if (FileHandler::file_exists(opts.layout_file)) {
+        if (!control_center.load_layout(opts.layout_file)) {
+            std::cerr << "Error: Failed to load layout file: " << opts.layout_file << std::endl;
+            return 1;
+        }
+        std::cout << "   Loaded layout (" << control_center.get_layout()->node_count() << " nodes) from "
+                  << opts.layout_file << std::endl;
+    } else if (opts.layout_file != LAYOUT_FILE) {
+        std::cerr << "Error: Cannot open file " << opts.layout_file << std::endl;
+        return 1;
+    }
+
+    // Optional mixed fleet (all modes); its vehicle count replaces --agvs
+    if (FileHandler::file_exists(opts.fleet_file)) {
+        if (!control_center.load_fleet(opts.fleet_file)) {
+            std::cerr << "Error: Failed to load fleet file: " << opts.fleet_file << std::endl;
+            return 1;
+        }
+        const FleetProfile* profile = control_center.get_fleet_profile();
+        opts.num_agvs = profile->fleet_size();
+        std::cout << "   Loaded fleet (" << profile->type_count() << " vehicle types, " << opts.num_agvs
+                  << " AGVs) from " << opts.fleet_file << std::endl;
+    } else if (opts.fleet_file != FLEET_FILE) {
+        std::cerr << "Error: Cannot open file " << opts.fleet_file << std::endl;
+        return 1;
+    }
+
+    // Optional sequence-dependent setup times (all modes)
+    if (FileHandler::file_exists(opts.setup_file)) {
+        if (!control_center.load_setup_matrix(opts.setup_file)) {
+            std::cerr << "Error: Failed to load setup file: " << opts.setup_file << std::endl;
+            return 1;
+        }
+        std::cout << "   Loaded setup times from " << opts.setup_file << std::endl;
+    } else if (opts.setup_file != SETUP_FILE) {
+        std::cerr << "Error: Cannot open file " << opts.setup_file << std::endl;
+        return 1;
+    }
+
+    // Optional workcenters and product routings (event-driven modes)
+    if (runs_threaded(opts) && FileHandler::file_exists(opts.routing_file)) {
+        std::cout << "   Ignoring " << opts.routing_file << " (workcenter routings need an event-driven mode)" << std::endl;
+    } else if (FileHandler::file_exists(opts.routing_file)) {
+        if (!control_center.load_routing(opts.routing_file)) {
+            std::cerr << "Error: Failed to load routing file: " << opts.routing_file << std::endl;
+            return 1;
+        }
+        std::cout << "   Loaded routings (" << control_center.get_workcenters()->size() << " workcenters) from "
+                  << opts.routing_file << std::endl;
+    } else if (opts.routing_file != ROUTING_FILE) {
+        std::cerr << "Error: Cannot open file " << opts.routing_file << std::endl;
+        return 1;
+    }
+
+    // Optional AGV battery model (event-driven modes)
+    BatteryModel battery;
+    if (runs_threaded(opts) && FileHandler::file_exists(opts.battery_file)) {
+        std::cout << "   Ignoring " << opts.battery_file << " (the battery model needs an event-driven mode)" << std::endl;
+    } else if (FileHandler::file_exists(opts.battery_file)) {
+        if (!FileHandler::read_battery_file(opts.battery_file, battery)) {
+            std::cerr << "Error: Failed to load battery file: " << opts.battery_file << std::endl;
+            return 1;
+        }
+        std::cout << "   Loaded battery model (" << battery.chargers << " chargers) from " << opts.battery_file << std::endl;
+    } else if (opts.battery_file != BATTERY_FILE) {
+        std::cerr << "Error: Cannot open file " << opts.battery_file << std::endl;
+        return 1;
+    }
+
+    // Pre-run material requirements: forecast shortages, skip orders that can never be built
+    MaterialPlan mrp = control_center.plan_materials(!opts.keep_unbuildable, opts.threads);
+    std::cout << "   MRP: " << mrp.short_components << " short components, " << mrp.starving_orders
+              << " starving orders, " << mrp.unbuildable_orders << " unbuildable"
+              << (mrp.unbuildable_orders > 0 && !opts.keep_unbuildable ? " (canceled)" : "") << " - see "
+              << MRP_REPORT_FILE << std::endl;
+
+    SimulationConfig config;
+    config.num_agvs = opts.num_agvs;
+    config.policy = opts.policy;
+    config.seed = opts.seed;
+    config.process_times = process_times;
+    config.layout = control_center.get_layout();
+    config.congestion_routing = opts.congestion;
+    config.dispatch_cycle_minutes = opts.dispatch_cycle;
+    config.backhaul = opts.backhaul;
+    config.station_slots = opts.station_slots;
+    config.setups = control_center.get_setup_matrix();
+    config.lookahead = opts.lookahead;
+    config.lot_window_minutes = opts.lot_window;
+    config.lot_max_size = opts.lot_size;
+    config.workcenters = control_center.get_workcenters();
+    config.station_output_buffer = opts.station_buffer;
+    config.battery = battery;
+    config.fleet = control_center.get_fleet_profile();
+    if ((opts.congestion || opts.dispatch_cycle > 0.0) && !config.layout) {
+        std::cerr << "Error: --congestion and --dispatch-cycle need a layout (" << LAYOUT_FILE
+                  << " or --layout FILE)" << std::endl;
+        return 1;
+    }
+
+    if (opts.estimate && !opts.deterministic) {
+        QueueingEstimator estimator(config);
+        print_estimate(estimator.estimate(control_center.get_orders(), control_center.get_products()), nullptr);
+        std::cout << "========================================\n";
+        return 0;
+    }
+
+    if (opts.optimize > 0) {
+        ConfigOptimizer optimizer(control_center.get_orders(), control_center.get_products(),
+                                  control_center.get_initial_inventory());
+        optimizer.set_threads(opts.threads);
+        optimizer.set_max_agvs(opts.num_agvs);
+
+        std::cout << "\nSearching configurations (up to " << opts.num_agvs << " AGVs, " << opts.optimize
+                  << " simulation runs, base seed " << opts.seed << ")...\n";
+        std::cout << "========================================\n";
+        OptimizationResult search = optimizer.optimize(config, opts.optimize);
+        std::string report = ConfigOptimizer::format_report(search);
+        std::cout << report.substr(0, report.find("\nAll evaluated"));
+        std::ofstream out(OPTIMIZER_REPORT_FILE);
+        if (out.is_open()) {
+            out << "========================================\n";
+            out << "  Configuration Search Report          \n";
+            out << "========================================\n\n";
+            out << report;
+        }
+        std::cout << "\nCheck " << OPTIMIZER_REPORT_FILE << " for every evaluated configuration\n";
+        std::cout << "========================================\n";
+        return 0;
+    }
+
+    if (opts.replications > 0) {
+        ReplicationRunner runner(control_center.get_orders(), control_center.get_products(),
+                                 control_center.get_initial_inventory());
+        runner.set_threads(opts.threads);
+
+        std::cout << "\nRunning " << opts.replications << " replications (" << opts.num_agvs
+                  << " AGVs, base seed " << opts.seed << ")...\n";
+        std::cout << "========================================\n";
+        std::vector<SimulationResult> runs = runner.run(config, opts.replications);
+        std::string report = ReplicationRunner::format_summary("Policy " + policy_name(opts.policy),
+                                                               ReplicationRunner::summarize(runs));
+
+        if (opts.compare) {
+            SimulationConfig other = config;
+            other.policy = opts.compare_policy;
+            std::vector<SimulationResult> other_runs = runner.run(other, opts.replications);
+            report += "\n" + ReplicationRunner::format_summary("Policy " + policy_name(opts.compare_policy),
+                                                                   ReplicationRunner::summarize(other_runs));
+            report += "\n" + ReplicationRunner::format_summary("Paired difference " + policy_name(opts.policy) + " - " +
+                                                               policy_name(opts.compare_policy) + " (common random numbers)",
+                ReplicationRunner::summarize_difference(runs, other_runs));
+        }
+
+        std::cout << report;
+        std::ofstream out(REPLICATION_REPORT_FILE);
+        if (out.is_open()) {
+            out << "========================================\n";
+            out << "  Monte Carlo Replication Report       \n";
+            out << "========================================\n\n";
+            out << report;
+        }
+        std::cout << "\nCheck " << REPLICATION_REPORT_FILE << " for the replication report\n";
+        std::cout << "========================================\n";
+        return 0;
+    }
+
+    if (opts.deterministic) {
+        std::cout << "\nStarting deterministic simulation (" << opts.num_agvs << " AGVs, seed "
+                  << opts.seed << ")...\n";
+        std::cout << "========================================\n";
+        QueueingEstimate estimate;
+        if (opts.estimate) estimate = QueueingEstimator(config).estimate(control_center.get_orders(), control_center.get_products());
+        SimulationResult result = control_center.run_deterministic(config);
+
+        std::cout << "\nAverage Lead Time: " << result.avg_lead_time << " minutes\n";
+        std::cout << "Assembly Station Utilization: " << (result.station_utilization * 100) << "%\n";
+        std::cout << "Throughput: " << result.throughput << " orders/hour\n";
+        std::cout << "Average AGV Utilization: " << (result.agv_utilization * 100) << "%\n";
+        if (config.layout) {
+            std::cout << "AGV empty travel: " << result.empty_km << " km (loaded " << result.loaded_km << " km)\n";
+        }
+        if (config.setups) {
+            double share = result.station_busy_minutes > 0.0 ? 100.0 * result.setup_minutes / result.station_busy_minutes : 0.0;
+            std::cout << "Setup time: " << result.setup_minutes << " slot-minutes (" << share << "% of station time, "
+                      << result.changeovers << " changeovers)\n";
+        }
+        if (config.lot_window_minutes > 0) {
+            std::cout << "Lots: " << result.lots << " of more than one order (window " << config.lot_window_minutes
+                      << " min)\n";
+        }
+        if (config.workcenters) {
+            std::cout << "Work in process moves: " << result.wip_moves << "\n";
+            for (const auto& wc : result.workcenter_stats) {
+                std::cout << "Workcenter " << wc.name << " (" << wc.machines << " machines): " << wc.operations
+                          << " operations, utilization " << (wc.utilization * 100) << "%, avg wait "
+                          << wc.avg_wait_minutes << " min, peak queue " << wc.peak_queue << "\n";
+                std::cout << "   buffers in " << buffer_size(wc.input_buffer) << " (avg " << wc.avg_input
+                          << "), out " << buffer_size(wc.output_buffer) << " (avg " << wc.avg_output << ", peak "
+                          << wc.peak_output << "), blocked " << wc.blocked_minutes << " machine-minutes\n";
+            }
+            std::cout << "Station blocked: " << result.station_blocked_minutes << " slot-minutes (output buffer "
+                      << buffer_size(config.station_output_buffer) << ")\n";
+            if (result.unfinished_jobs > 0) {
+                std::cout << "Warning: " << result.unfinished_jobs
+                          << " routed orders never finished (buffers deadlocked; enlarge them)\n";
+            }
+        }
+        if (config.backhaul) {
+            std::cout << "Backhaul trips: " << result.backhaul_trips << " finished products\n";
+        }
+        if (result.dispatch_cycles > 0) {
+            std::cout << "Dispatch cycles: " << result.dispatch_cycles << " (avg solve "
+                      << result.avg_cycle_solve_us << " us)\n";
+        }
+        if (config.battery.enabled) {
+            // Same seed without the battery model: the difference is the throughput lost to charging
+            SimulationConfig unlimited = config;
+            unlimited.battery = BatteryModel();
+            std::vector<Order> orders = control_center.get_orders();
+            DiscreteEventSimulator reference(unlimited);
+            SimulationResult free_run = reference.run(orders, control_center.get_products(),
+                                                      control_center.get_initial_inventory());
+            double loss = free_run.throughput > 0.0 ? 100.0 * (1.0 - result.throughput / free_run.throughput) : 0.0;
+            std::cout << "Charging: " << result.charges << " sessions, " << result.charging_minutes
+                      << " AGV-minutes out of service (" << result.charger_wait_minutes
+                      << " queuing for " << config.battery.chargers << " chargers), lowest charge "
+                      << result.min_soc << "%\n";
+            std::cout << "Throughput without charging: " << free_run.throughput << " orders/hour (loss "
+                      << loss << "%)\n";
+        }
+        if (config.congestion_routing) {
+            std::cout << "AGV congestion delay: " << result.congestion_delay_minutes << " minutes (fleet total)\n";
+            if (result.forced_route_entries > 0) {
+                std::cout << "Warning: " << result.forced_route_entries << " aisle entries found no conflict-free time"
+                          << " and were taken anyway\n";
+            }
+        }
+        std::cout << "Event trace hash: 0x" << std::hex << std::setw(16) << std::setfill('0')
+                  << result.trace_hash << std::dec << " (" << result.events_processed << " events)\n";
+        if (opts.estimate) print_estimate(estimate, &result);
+        std::cout << "\nSimulation complete!\n";
+        std::cout << "Check " << LOG_FILE << " for detailed logs\n";
+        std::cout << "Check " << KPI_REPORT_FILE << " for performance metrics\n";
+        std::cout << "Check " << KPI_TIMESERIES_FILE << " for per-window KPIs\n";
+        std::cout << "Check " << AGV_REPORT_FILE << " for per-AGV busy time and congestion delay\n";
+        std::cout << "========================================\n";
+        return 0;
+    }
+
     // Create AGV fleet (threads will be started by ControlCenter)
-    std::cout << "\nInitializing AGV fleet (" << NUM_AGVS << " AGVs)...\n";
-    for (int i = 1; i <= NUM_AGVS; i++) {
+    std::cout << "\nInitializing AGV fleet (" << opts.num_agvs << " AGVs)...\n";
+    for (int i = 1; i <= opts.num_agvs; i++) {
         AGV* agv = new AGV(i);
         agv_fleet.push_back(agv);
         std::cout << "   AGV" << i << " initialized\n";
     }
     
-    // Set scheduling policy (default: FIFO)
-    control_center.set_scheduling_policy(SchedulingPolicy::FIFO);
+    // Set scheduling policy (default: FIFO, --policy)
+    control_center.set_scheduling_policy(opts.policy);
+    assembly_station.set_backhaul(opts.backhaul);
+    assembly_station.set_capacity(opts.station_slots);
+    control_center.set_lot_batching(opts.lot_window, opts.lot_size);
 
-    // Optional: silence diagnostics for final runs
-    // control_center.set_diag_logging(false);
+    SimClock::set_time_scale(TIME_SCALE);
     
     // Start simulation (ControlCenter wires station and starts all threads)
     std::cout << "\nStarting simulation...\n";
@@ -105,6 +662,8 @@ int main(int argc, char* argv[]) {
     std::cout << "\nSimulation complete!\n";
     std::cout << "Check " << LOG_FILE << " for detailed logs\n";
     std::cout << "Check " << KPI_REPORT_FILE << " for performance metrics\n";
+    std::cout << "Check " << KPI_TIMESERIES_FILE << " for per-window KPIs\n";
+    std::cout << "Check " << AGV_REPORT_FILE << " for per-AGV busy time\n";
     std::cout << "========================================\n";
     
     return 0;
@@ -0,0 +1,449 @@
+/**
+ * @file fas_scenario_gen.cpp
+ * @brief Synthetic large-scale scenario generator (orders.txt, bom.txt, warehouse.txt)
+ * @description Emits input files in the simulator's formats at configurable
+ *              scale. Output is a pure function of the options and --seed:
+ *              the generator uses its own PRNG and distribution transforms
+ *              (no std::*_distribution) so files are identical across
+ *              platforms and standard libraries.
+ */
+
+/*****************************Standard Libraries***************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+/*************************************************************************************/
+
+/****************************Random Number Generation*********************************/
+/**
+ * @class Rng
+ * @brief xoshiro256** seeded through splitmix64
+ */
+class Rng {
+public:
+    explicit Rng(uint64_t seed) {
+        for (int i = 0; i < 4; ++i) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s[i] = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1) with 53 random bits
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Uniform integer in [lo, hi]
+    int64_t range(int64_t lo, int64_t hi) { return lo + (int64_t)(next() % (uint64_t)(hi - lo + 1)); }
+
+    // Exponential with the given mean (inverse CDF)
+    double exponential(double mean) { return -mean * std::log(1.0 - uniform()); }
+
+private:
+    uint64_t s[4];
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/**
+ * @class ZipfTable
+ * @brief Skewed popularity over n items (rank 0 most popular), sampled by CDF search
+ */
+class ZipfTable {
+public:
+    ZipfTable(size_t n, double exponent) : cdf(n) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += 1.0 / std::pow((double)(i + 1), exponent);
+            cdf[i] = sum;
+        }
+        for (size_t i = 0; i < n; ++i) cdf[i] /= sum;
+    }
+
+    size_t sample(Rng& rng) const {
+        double u = rng.uniform();
+        size_t idx = (size_t)(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+        return idx < cdf.size() ? idx : cdf.size() - 1;
+    }
+
+private:
+    std::vector<double> cdf;
+};
+/*************************************************************************************/
+
+
+/****************************Buffered Output******************************************/
+/**
+ * @class BufferedWriter
+ * @brief Large-buffer writer with hand-rolled integer formatting
+ */
+class BufferedWriter {
+public:
+    explicit BufferedWriter(const std::string& filename) : used(0), total(0), buffer(1 << 22) {
+        fp = std::fopen(filename.c_str(), "wb");
+        if (!fp) std::cerr << "Error: Cannot create file " << filename << std::endl;
+    }
+    ~BufferedWriter() { close(); }
+
+    bool ok() const { return fp != nullptr; }
+    unsigned long long bytes_written() const { return total + used; }
+
+    void put(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+    }
+
+    void put(const char* str) {
+        while (*str) put(*str++);
+    }
+
+    void put_int(long long v) {
+        char tmp[24];
+        int n = 0;
+        bool neg = v < 0;
+        unsigned long long u = neg ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        do { tmp[n++] = (char)('0' + u % 10); u /= 10; } while (u);
+        if (neg) tmp[n++] = '-';
+        if (used + n > buffer.size()) flush();
+        while (n) buffer[used++] = tmp[--n];
+    }
+
+    // Two-digit zero padded value (clock minutes)
+    void put_2d(int v) { put((char)('0' + v / 10)); put((char)('0' + v % 10)); }
+
+    void close() {
+        if (!fp) return;
+        flush();
+        std::fclose(fp);
+        fp = nullptr;
+    }
+
+private:
+    std::FILE* fp;
+    size_t used;
+    unsigned long long total;
+    std::vector<char> buffer;
+
+    void flush() {
+        if (fp && used) std::fwrite(buffer.data(), 1, used, fp);
+        total += used;
+        used = 0;
+    }
+};
+/*************************************************************************************/
+
+
+/****************************Scenario Options*****************************************/
+/**
+ * @struct ScenarioOptions
+ * @brief Generator parameters (all settable from the command line)
+ */
+struct ScenarioOptions {
+    std::string out_dir;
+    uint64_t seed;
+    long long num_orders;
+    int num_products;
+    int num_components;
+    int bom_lines;          // Component lines per product
+    int max_quantity;       // Max units per BOM line
+    int bom_depth;          // Product levels; levels above the last also use a subassembly (1 = flat)
+    std::string arrivals;   // "poisson" or "bursty"
+    double rate_per_hour;   // Mean arrival rate (poisson) / calm-phase rate (bursty)
+    double burst_factor;    // Rate multiplier during bursts
+    double zipf_exponent;   // Popularity skew for products and components (0 = uniform)
+    double coverage;        // Stock as a multiple of total demand
+    double shortage_fraction;  // Fraction of demanded components stocked below demand
+    int num_priorities;
+    int start_minutes;
+
+    ScenarioOptions()
+        : out_dir("input"), seed(1), num_orders(1000), num_products(50), num_components(200),
+          bom_lines(8), max_quantity(4), bom_depth(1), arrivals("poisson"), rate_per_hour(20.0),
+          burst_factor(5.0), zipf_exponent(1.0), coverage(1.2), shortage_fraction(0.0),
+          num_priorities(5), start_minutes(8 * 60) {}
+};
+
+static void print_usage() {
+    std::cerr <<
+        "Usage: fas_scenario_gen [options]\n"
+        "  --out DIR            output directory (default input)\n"
+        "  --seed N             RNG seed; same seed and options give identical files (default 1)\n"
+        "  --orders N           number of orders (default 1000)\n"
+        "  --products N         number of products (default 50)\n"
+        "  --components N       number of components (default 200)\n"
+        "  --bom-lines N        component lines per product (default 8)\n"
+        "  --max-qty N          max units per BOM line (default 4)\n"
+        "  --bom-depth N        product levels; each level uses a subassembly of the next (default 1 = flat)\n"
+        "  --arrivals MODE      poisson | bursty (default poisson)\n"
+        "  --rate R             mean arrivals per hour (default 20)\n"
+        "  --burst-factor F     rate multiplier during bursts (default 5)\n"
+        "  --zipf S             popularity skew exponent, 0 = uniform (default 1.0)\n"
+        "  --coverage F         stock as multiple of total demand (default 1.2)\n"
+        "  --shortage F         fraction of components stocked below demand (default 0)\n"
+        "  --priorities N       priority levels (default 5)\n"
+        "  --start HH:MM        first possible release time (default 08:00)\n";
+}
+
+static bool parse_options(int argc, char* argv[], ScenarioOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) { std::cerr << "Error: missing value for " << arg << std::endl; return false; }
+        std::string val = argv[++i];
+        if (arg == "--out") opt.out_dir = val;
+        else if (arg == "--seed") opt.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else if (arg == "--orders") opt.num_orders = std::atoll(val.c_str());
+        else if (arg == "--products") opt.num_products = std::atoi(val.c_str());
+        else if (arg == "--components") opt.num_components = std::atoi(val.c_str());
+        else if (arg == "--bom-lines") opt.bom_lines = std::atoi(val.c_str());
+        else if (arg == "--max-qty") opt.max_quantity = std::atoi(val.c_str());
+        else if (arg == "--bom-depth") opt.bom_depth = std::atoi(val.c_str());
+        else if (arg == "--arrivals") opt.arrivals = val;
+        else if (arg == "--rate") opt.rate_per_hour = std::atof(val.c_str());
+        else if (arg == "--burst-factor") opt.burst_factor = std::atof(val.c_str());
+        else if (arg == "--zipf") opt.zipf_exponent = std::atof(val.c_str());
+        else if (arg == "--coverage") opt.coverage = std::atof(val.c_str());
+        else if (arg == "--shortage") opt.shortage_fraction = std::atof(val.c_str());
+        else if (arg == "--priorities") opt.num_priorities = std::atoi(val.c_str());
+        else if (arg == "--start") {
+            int hh = 0, mm = 0;
+            if (std::sscanf(val.c_str(), "%d:%d", &hh, &mm) != 2) { std::cerr << "Error: bad --start " << val << std::endl; return false; }
+            opt.start_minutes = hh * 60 + mm;
+        } else {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    if (opt.num_orders < 0 || opt.num_products <= 0 || opt.num_components <= 0 ||
+        opt.bom_lines <= 0 || opt.max_quantity <= 0 || opt.bom_depth <= 0 || opt.rate_per_hour <= 0.0 ||
+        opt.num_priorities <= 0 || (opt.arrivals != "poisson" && opt.arrivals != "bursty")) {
+        std::cerr << "Error: invalid option values" << std::endl;
+        return false;
+    }
+    opt.bom_lines = std::min(opt.bom_lines, opt.num_components);
+    opt.bom_depth = std::min(opt.bom_depth, opt.num_products);
+    return true;
+}
+/*************************************************************************************/
+
+
+/****************************Scenario Generation**************************************/
+/**
+ * @struct BomLine
+ * @brief One generated BOM entry (component index, or product index for a subassembly; quantity)
+ */
+struct BomLine {
+    int component;
+    int quantity;
+};
+
+/**
+ * @brief First product index of BOM level `level` (products are split into bom_depth contiguous levels)
+ */
+static int level_start(const ScenarioOptions& opt, int level) {
+    return (int)(((long long)level * opt.num_products + opt.bom_depth - 1) / opt.bom_depth);
+}
+
+/**
+ * @brief Generate and write bom.txt; products draw components by Zipf popularity
+ * @param subassemblies Filled with each product's subassembly lines (product indices)
+ *
+ * With --bom-depth N the products are split into N levels by index and
+ * every product above the last level also uses one product of the next
+ * level. Subassemblies always have a higher index, so the BOM has no cycles.
+ */
+static bool write_bom(const ScenarioOptions& opt, Rng& rng, std::vector<std::vector<BomLine> >& boms,
+                      std::vector<std::vector<BomLine> >& subassemblies, unsigned long long& bytes) {
+    BufferedWriter out(opt.out_dir + "/bom.txt");
+    if (!out.ok()) return false;
+
+    ZipfTable component_popularity((size_t)opt.num_components, opt.zipf_exponent);
+    std::vector<int> last_used(opt.num_components, -1);  // Per-product dedup marker
+    boms.assign(opt.num_products, std::vector<BomLine>());
+    subassemblies.assign(opt.num_products, std::vector<BomLine>());
+
+    for (int p = 0; p < opt.num_products; ++p) {
+        out.put('P'); out.put_int(p + 1); out.put(' ');
+        out.put_int(rng.range(10, 60)); out.put('\n');
+        while ((int)boms[p].size() < opt.bom_lines) {
+            int c = (int)component_popularity.sample(rng);
+            if (last_used[c] == p) {
+                // Heavily skewed tables repeat the head often; fall back to a uniform pick
+                c = (int)rng.range(0, opt.num_components - 1);
+                if (last_used[c] == p) continue;
+            }
+            last_used[c] = p;
+            BomLine line = { c, (int)rng.range(1, opt.max_quantity) };
+            boms[p].push_back(line);
+            out.put('P'); out.put_int(p + 1); out.put(" C"); out.put_int(c + 1);
+            out.put(' '); out.put_int(line.quantity); out.put('\n');
+        }
+        int level = (int)((long long)p * opt.bom_depth / opt.num_products);
+        if (level + 1 < opt.bom_depth) {
+            // Drawn only for deep BOMs, so flat files stay identical for a given seed
+            BomLine sub = { (int)rng.range(level_start(opt, level + 1), level_start(opt, level + 2) - 1),
+                            (int)rng.range(1, std::min(2, opt.max_quantity)) };
+            subassemblies[p].push_back(sub);
+            out.put('P'); out.put_int(p + 1); out.put(" P"); out.put_int(sub.component + 1);
+            out.put(' '); out.put_int(sub.quantity); out.put('\n');
+        }
+        out.put('\n');
+    }
+    out.close();
+    bytes += out.bytes_written();
+    return true;
+}
+
+/**
+ * @brief Generate and write orders.txt in release-time order
+ * @param product_counts Filled with the number of orders per product
+ */
+static bool write_orders(const ScenarioOptions& opt, Rng& rng, std::vector<long long>& product_counts,
+                         unsigned long long& bytes) {
+    BufferedWriter out(opt.out_dir + "/orders.txt");
+    if (!out.ok()) return false;
+
+    ZipfTable product_popularity((size_t)opt.num_products, opt.zipf_exponent);
+    product_counts.assign(opt.num_products, 0);
+
+    // Bursty arrivals: two-phase modulated Poisson process (calm ~60 min, burst ~15 min)
+    const double calm_mean_minutes = 60.0;
+    const double burst_mean_minutes = 15.0;
+    bool bursty = opt.arrivals == "bursty";
+    bool in_burst = false;
+    double phase_end = bursty ? rng.exponential(calm_mean_minutes) : 0.0;
+
+    double t = (double)opt.start_minutes;
+    for (long long i = 0; i < opt.num_orders; ++i) {
+        double rate = opt.rate_per_hour / 60.0;
+        if (bursty) {
+            double gap = rng.exponential(1.0 / (in_burst ? rate * opt.burst_factor : rate));
+            while (t + gap > opt.start_minutes + phase_end) {
+                // Memoryless: restart the draw at the phase boundary with the new rate
+                t = opt.start_minutes + phase_end;
+                in_burst = !in_burst;
+                phase_end += rng.exponential(in_burst ? burst_mean_minutes : calm_mean_minutes);
+                gap = rng.exponential(1.0 / (in_burst ? rate * opt.burst_factor : rate));
+            }
+            t += gap;
+        } else {
+            t += rng.exponential(1.0 / rate);
+        }
+
+        long long minute = (long long)t;
+        size_t product = product_popularity.sample(rng);
+        product_counts[product]++;
+
+        if (minute < 600) out.put('0');  // HH MM like the hand-written files
+        out.put_int(minute / 60); out.put(' '); out.put_2d((int)(minute % 60));
+        out.put(" P"); out.put_int((long long)product + 1); out.put(' ');
+        out.put_int(rng.range(1, opt.num_priorities)); out.put('\n');
+    }
+    out.close();
+    bytes += out.bytes_written();
+    return true;
+}
+
+/**
+ * @brief Write warehouse.txt with stock derived from total demand, injecting shortages
+ * @return Number of components stocked below demand
+ *
+ * Demand is taken over the exploded leaves: the units built of each product
+ * (its orders plus its uses as a subassembly) times its component lines.
+ * Parents have lower indices than their subassemblies, so one ascending
+ * pass settles every product's units before its lines are counted.
+ */
+static int write_warehouse(const ScenarioOptions& opt, Rng& rng,
+                           const std::vector<std::vector<BomLine> >& boms,
+                           const std::vector<std::vector<BomLine> >& subassemblies,
+                           const std::vector<long long>& product_counts,
+                           unsigned long long& bytes, bool& ok) {
+    std::vector<long long> units(product_counts);
+    std::vector<long long> demand(opt.num_components, 0);
+    for (int p = 0; p < opt.num_products; ++p) {
+        for (const auto& sub : subassemblies[p]) units[sub.component] += units[p] * sub.quantity;
+        for (const auto& line : boms[p]) demand[line.component] += units[p] * line.quantity;
+    }
+
+    BufferedWriter out(opt.out_dir + "/warehouse.txt");
+    ok = out.ok();
+    if (!ok) return 0;
+
+    int shortages = 0;
+    for (int c = 0; c < opt.num_components; ++c) {
+        long long stock;
+        if (demand[c] > 0 && rng.uniform() < opt.shortage_fraction) {
+            stock = (long long)(demand[c] * (0.2 + 0.6 * rng.uniform()));  // 20-80% of demand
+            shortages++;
+        } else if (demand[c] > 0) {
+            stock = (long long)std::ceil(demand[c] * opt.coverage);
+        } else {
+            stock = rng.range(10, 100);
+        }
+        out.put('C'); out.put_int(c + 1); out.put(' '); out.put_int(stock); out.put('\n');
+    }
+    out.close();
+    bytes += out.bytes_written();
+    return shortages;
+}
+/*************************************************************************************/
+
+
+/*******************************Main Function*****************************************/
+int main(int argc, char* argv[]) {
+    ScenarioOptions opt;
+    if (!parse_options(argc, argv, opt)) {
+        print_usage();
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(opt.out_dir, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot create directory " << opt.out_dir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Independent streams so changing one part (e.g. --orders) leaves the BOM unchanged
+    Rng bom_rng(opt.seed * 3 + 0);
+    Rng order_rng(opt.seed * 3 + 1);
+    Rng stock_rng(opt.seed * 3 + 2);
+
+    std::vector<std::vector<BomLine> > boms;
+    std::vector<std::vector<BomLine> > subassemblies;
+    std::vector<long long> product_counts;
+    unsigned long long bytes = 0;
+    bool ok = true;
+
+    if (!write_bom(opt, bom_rng, boms, subassemblies, bytes)) return 1;
+    if (!write_orders(opt, order_rng, product_counts, bytes)) return 1;
+    int shortages = write_warehouse(opt, stock_rng, boms, subassemblies, product_counts, bytes, ok);
+    if (!ok) return 1;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Generated " << opt.num_orders << " orders, " << opt.num_products << " products, "
+              << opt.num_components << " components (" << shortages << " short) in "
+              << opt.out_dir << "/ : " << bytes / 1e6 << " MB in " << seconds << " s" << std::endl;
+    return 0;
+}
+/********************************End of Main Function********************************/